@@ -22,4 +22,12 @@ byte chr_Calendar[] = {
 
 byte chr_Drop[] = {
   0x00, 0x04, 0x04, 0x0E, 0x0E, 0x1F, 0x1F, 0x0E
+};
+
+byte chr_Sunrise[] = {
+    0x04, 0x0E, 0x1F, 0x00, 0x0E, 0x1F, 0x00, 0x1F
+};
+
+byte chr_Sunset[] = {
+    0x1F, 0x0E, 0x04, 0x00, 0x0E, 0x1F, 0x00, 0x1F
 };
\ No newline at end of file
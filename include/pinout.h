@@ -1,13 +1,37 @@
 #define RELAY1 2
 #define RELAY2 3
 
+// relays on a 74HC595 chain instead, build with -D RELAYS_SHIFT_REGISTER
+#define SHIFT_LATCH 10
+#define SHIFT_DATA 11
+#define SHIFT_CLOCK 13
+
+// relays on a PCF8574 on the I2C bus of the LCD instead, build with -D RELAYS_EXPANDER
+#define RELAY_EXPANDER_ADDRESS 0x20
+
 #define RTC_RST 8
 #define RTC_DAT 7
 #define RTC_CLK 6
 
+// encoder and "water now" buttons must be on port C, they use PCINT1_vect
 #define ROTARYENCODER_PIN1 A2
 #define ROTARYENCODER_PIN2 A3
-#define ROTARYENCODER_BUTTON 4
+#define ROTARYENCODER_BUTTON 4 // must be on port D, uses PCINT2_vect
+
+// hall-effect flow sensor in the supply line, on port D like the rotary button
+#define FLOW_SENSOR 5
+
+// "water now" buttons, all on port C
+#define WATERNOW_BUTTON1 A0
+#define WATERNOW_BUTTON2 A1
+
+// soil moisture probes on the analog-only inputs, powered from D9 while measured
+#define MOISTURE_PROBE1 A6
+#define MOISTURE_PROBE2 A7
+#define MOISTURE_POWER 9
+
+// DS18B20 temperature sensor, 1-Wire with a 4.7k pull-up
+#define TEMPERATURE_SENSOR 12
 
 // LCD is connected via SDA and SCL
 // Arduino Nano
@@ -1,7 +1,7 @@
 #include "LiquidCrystal_I2C.h"
 #include <inttypes.h>
 #include <Arduino.h>
-#include <Wire.h>
+#include <TwiMaster.h>
 
 // When the display powers up, it is configured as follows:
 //
@@ -29,77 +29,134 @@ LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t lcd_addr, uint8_t lcd_cols, uint8_t
 	_rows = lcd_rows;
 	_charsize = charsize;
 	_backlightval = LCD_BACKLIGHT;
+	_initStep = 0;
+	_waitStart = 0;
+	_waitMicros = 0;
+	_busyStart = 0;
+	_busyMicros = 0;
+	_failed = false;
 }
 
 void LiquidCrystal_I2C::begin() {
-	Wire.begin();
-	_displayfunction = LCD_4BITMODE | LCD_1LINE | LCD_5x8DOTS;
-
-	if (_rows > 1) {
-		_displayfunction |= LCD_2LINE;
+	while (!beginStep()) {
+		// the display needs time before the next step
 	}
+}
 
-	// for some 1 line displays you can select a 10 pixel high font
-	if ((_charsize != 0) && (_rows == 1)) {
-		_displayfunction |= LCD_5x10DOTS;
+bool LiquidCrystal_I2C::beginStep() {
+	if ((unsigned long)(micros() - _waitStart) < _waitMicros) {
+		return false;
+	}
+	_waitStart = micros();
+	_waitMicros = 0;
+
+	switch (_initStep) {
+	case 0:
+		Twi.begin();
+		_displayfunction = LCD_4BITMODE | LCD_1LINE | LCD_5x8DOTS;
+
+		if (_rows > 1) {
+			_displayfunction |= LCD_2LINE;
+		}
+
+		// for some 1 line displays you can select a 10 pixel high font
+		if ((_charsize != 0) && (_rows == 1)) {
+			_displayfunction |= LCD_5x10DOTS;
+		}
+
+		// SEE PAGE 45/46 FOR INITIALIZATION SPECIFICATION!
+		// according to datasheet, we need at least 40ms after power rises above 2.7V
+		// before sending commands. Arduino can turn on way befer 4.5V so we'll wait 50
+		_waitMicros = 50000UL;
+		break;
+
+	case 1:
+		// Now we pull both RS and R/W low to begin commands
+		expanderWrite(_backlightval);	// reset expanderand turn backlight off (Bit 8 =1)
+		_waitMicros = 1000000UL;
+		break;
+
+	case 2:
+	case 3:
+		//put the LCD into 4 bit mode
+		// this is according to the hitachi HD44780 datasheet
+		// figure 24, pg 46
+
+		// we start in 8bit mode, try to set 4 bit mode (twice)
+		write4bits(0x03 << 4);
+		_waitMicros = 4500; // wait min 4.1ms
+		break;
+
+	case 4:
+		// third go!
+		write4bits(0x03 << 4);
+		_waitMicros = 150;
+		break;
+
+	case 5:
+		// finally, set to 4-bit interface
+		write4bits(0x02 << 4);
+
+		// set # lines, font size, etc.
+		command(LCD_FUNCTIONSET | _displayfunction);
+
+		// turn the display on with no cursor or blinking default
+		_displaycontrol = LCD_DISPLAYON | LCD_CURSOROFF | LCD_BLINKOFF;
+		display();
+
+		// clear it off
+		clear();
+		_waitMicros = _busyMicros;
+		break;
+
+	case 6:
+		// Initialize to default text direction (for roman languages)
+		_displaymode = LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT;
+
+		// set the entry mode
+		command(LCD_ENTRYMODESET | _displaymode);
+
+		home();
+		_waitMicros = _busyMicros;
+		break;
+
+	default:
+		// initialized
+		return true;
 	}
 
-	// SEE PAGE 45/46 FOR INITIALIZATION SPECIFICATION!
-	// according to datasheet, we need at least 40ms after power rises above 2.7V
-	// before sending commands. Arduino can turn on way befer 4.5V so we'll wait 50
-	delay(50);
-
-	// Now we pull both RS and R/W low to begin commands
-	expanderWrite(_backlightval);	// reset expanderand turn backlight off (Bit 8 =1)
-	delay(1000);
-
-	//put the LCD into 4 bit mode
-	// this is according to the hitachi HD44780 datasheet
-	// figure 24, pg 46
-
-	// we start in 8bit mode, try to set 4 bit mode
-	write4bits(0x03 << 4);
-	delayMicroseconds(4500); // wait min 4.1ms
-
-	// second try
-	write4bits(0x03 << 4);
-	delayMicroseconds(4500); // wait min 4.1ms
-
-	// third go!
-	write4bits(0x03 << 4);
-	delayMicroseconds(150);
-
-	// finally, set to 4-bit interface
-	write4bits(0x02 << 4);
-
-	// set # lines, font size, etc.
-	command(LCD_FUNCTIONSET | _displayfunction);
-
-	// turn the display on with no cursor or blinking default
-	_displaycontrol = LCD_DISPLAYON | LCD_CURSOROFF | LCD_BLINKOFF;
-	display();
-
-	// clear it off
-	clear();
-
-	// Initialize to default text direction (for roman languages)
-	_displaymode = LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT;
-
-	// set the entry mode
-	command(LCD_ENTRYMODESET | _displaymode);
-
-	home();
+	_initStep++;
+	return false;
 }
 
 /********** high level commands, for the user! */
 void LiquidCrystal_I2C::clear(){
 	command(LCD_CLEARDISPLAY);// clear display, set cursor position to zero
-	delayMicroseconds(2000);  // this command takes a long time!
+	_busyStart = micros();    // this command takes a long time!
+	_busyMicros = 2000;       // the next command waits for the rest
 }
 
 void LiquidCrystal_I2C::home(){
 	command(LCD_RETURNHOME);  // set cursor position to zero
-	delayMicroseconds(2000);  // this command takes a long time!
+	_busyStart = micros();    // this command takes a long time!
+	_busyMicros = 2000;       // the next command waits for the rest
+}
+
+bool LiquidCrystal_I2C::busy(){
+	return (unsigned long)(micros() - _busyStart) < _busyMicros;
+}
+
+bool LiquidCrystal_I2C::failed(){
+	return _failed;
+}
+
+void LiquidCrystal_I2C::restart(){
+	// give a loose cable or a stuck bus some time before the next try
+	_initStep = 0;
+	_failed = false;
+	_busyMicros = 0;
+	_waitStart = micros();
+	_waitMicros = 500000UL;
 }
 
 void LiquidCrystal_I2C::setCursor(uint8_t col, uint8_t row){
@@ -213,29 +270,47 @@ inline size_t LiquidCrystal_I2C::write(uint8_t value) {
 
 // write either command or data
 void LiquidCrystal_I2C::send(uint8_t value, uint8_t mode) {
+	waitBusy();
 	uint8_t highnib=value&0xf0;
 	uint8_t lownib=(value<<4)&0xf0;
 	write4bits((highnib)|mode);
 	write4bits((lownib)|mode);
 }
 
+// the data, the enable pulse and enable low are sent in one transaction.
+// At 100kHz every byte takes 90us, longer than the 450ns enable pulse and the
+// 37us the commands need to settle, so no delays are needed.
+// After a failed transaction nothing is sent until restart(), so a broken bus
+// costs one timeout, not one per character.
 void LiquidCrystal_I2C::write4bits(uint8_t value) {
-	expanderWrite(value);
-	pulseEnable(value);
+	if (_failed) {
+		return;
+	}
+	uint8_t data[3] = {
+		(uint8_t)(value | _backlightval),
+		(uint8_t)((value | En) | _backlightval),	// En high
+		(uint8_t)((value & ~En) | _backlightval)	// En low
+	};
+	if (Twi.write(_addr, data, sizeof(data)) != TwiMaster::OK) {
+		_failed = true;
+	}
 }
 
 void LiquidCrystal_I2C::expanderWrite(uint8_t _data){
-	Wire.beginTransmission(_addr);
-	Wire.write((int)(_data) | _backlightval);
-	Wire.endTransmission();
+	if (_failed) {
+		return;
+	}
+	uint8_t data = _data | _backlightval;
+	if (Twi.write(_addr, &data, 1) != TwiMaster::OK) {
+		_failed = true;
+	}
 }
 
-void LiquidCrystal_I2C::pulseEnable(uint8_t _data){
-	expanderWrite(_data | En);	// En high
-	delayMicroseconds(1);		// enable pulse must be >450ns
-
-	expanderWrite(_data & ~En);	// En low
-	delayMicroseconds(50);		// commands need > 37us to settle
+void LiquidCrystal_I2C::waitBusy(){
+	while (busy()) {
+		// bounded by the 2ms of clear() and home()
+	}
+	_busyMicros = 0;
 }
 
 void LiquidCrystal_I2C::load_custom_character(uint8_t char_num, uint8_t *rows){
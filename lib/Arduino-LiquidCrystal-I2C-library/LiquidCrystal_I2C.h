@@ -75,6 +75,31 @@ public:
 	 */
 	void begin();
 
+	/**
+	 * Non-blocking version of begin(). Call it repeatedly until it returns true. Every call
+	 * sends at most one step of the initialization sequence and returns false while the
+	 * display still needs time before the next step.
+	 */
+	bool beginStep();
+
+	/**
+	 * True while the display executes clear() or home(). A command sent before waits for
+	 * the rest of the time, so check this to avoid waiting.
+	 */
+	bool busy();
+
+	/**
+	 * True after an I2C transaction failed, e.g. because of a loose cable. The display
+	 * may have lost half of a command, so nothing is sent until restart() is called.
+	 */
+	bool failed();
+
+	/**
+	 * Clear the failure and initialize the display again with beginStep(), after a pause.
+	 * The content has to be sent again.
+	 */
+	void restart();
+
 	 /**
 	  * Remove all the characters currently shown. Next print/write operation will start
 	  * from the first position on LCD display.
@@ -151,7 +176,7 @@ private:
 	void send(uint8_t, uint8_t);
 	void write4bits(uint8_t);
 	void expanderWrite(uint8_t);
-	void pulseEnable(uint8_t);
+	void waitBusy();
 	uint8_t _addr;
 	uint8_t _displayfunction;
 	uint8_t _displaycontrol;
@@ -160,6 +185,12 @@ private:
 	uint8_t _rows;
 	uint8_t _charsize;
 	uint8_t _backlightval;
+	uint8_t _initStep;
+	unsigned long _waitStart;
+	unsigned long _waitMicros;
+	unsigned long _busyStart;
+	unsigned int _busyMicros;
+	bool _failed;
 };
 
 #endif // FDB_LIQUID_CRYSTAL_I2C_H
@@ -0,0 +1,172 @@
+// -----
+// ButtonBank.cpp - Library for detecting clicks, double clicks and long presses
+// on up to 8 buttons connected to the same port.
+// -----
+// 19.10.2026 created
+// -----
+
+#include "ButtonBank.h"
+
+// ----- Initialization and Default Values -----
+
+ButtonBank::ButtonBank()
+{
+  // initialization is in the class declaration.
+}
+
+
+int8_t ButtonBank::addButton(uint8_t pin, bool activeLow, bool pullupActive)
+{
+  volatile uint8_t *pinReg = portInputRegister(digitalPinToPort(pin));
+
+  if (_count >= BUTTONBANK_MAX)
+    return -1;
+  if ((_pinReg != NULL) && (pinReg != _pinReg))
+    return -1;
+
+  _pinReg = pinReg;
+  _mask[_count] = digitalPinToBitMask(pin);
+  _state[_count] = IDLE;
+  _time[_count] = 0;
+
+  if (activeLow) {
+    // the button connects the input pin to GND when pressed.
+    _invertMask |= _mask[_count];
+  }
+
+  if (pullupActive) {
+    pinMode(pin, INPUT_PULLUP);
+  } else {
+    pinMode(pin, INPUT);
+  }
+
+  return _count++;
+} // addButton
+
+
+void ButtonBank::setDebounceTicks(uint8_t ticks)
+{
+  _debounceTicks = ticks;
+} // setDebounceTicks
+
+
+void ButtonBank::setClickTicks(uint16_t ticks)
+{
+  _clickTicks = ticks;
+} // setClickTicks
+
+
+void ButtonBank::setPressTicks(uint16_t ticks)
+{
+  _pressTicks = ticks;
+} // setPressTicks
+
+
+void ButtonBank::setDoubleClick(bool enabled)
+{
+  _doubleClick = enabled;
+} // setDoubleClick
+
+
+void ButtonBank::attachEvent(eventFunction newFunction)
+{
+  _eventFunc = newFunction;
+} // attachEvent
+
+
+bool ButtonBank::isLongPressed(uint8_t index)
+{
+  return (index < _count) && (_state[index] == LONG);
+}
+
+
+uint8_t ButtonBank::getButtonCount()
+{
+  return _count;
+}
+
+
+void ButtonBank::_dispatch(uint8_t index, Event event)
+{
+  if (_eventFunc)
+    _eventFunc(index, event);
+}
+
+
+/**
+ * @brief Read the port once and advance the finite state machine (FSM) of
+ * every button.
+ */
+void ButtonBank::tick(void)
+{
+  if (_count == 0)
+    return;
+
+  // one read for all buttons, active buttons have their bit set.
+  uint8_t active = *_pinReg ^ _invertMask;
+  uint16_t now = (uint16_t)millis();
+
+  for (uint8_t i = 0; i < _count; i++) {
+    bool activeLevel = (active & _mask[i]) != 0;
+    uint16_t elapsed = now - _time[i];
+
+    switch (_state[i]) {
+    case IDLE:
+      if (activeLevel) {
+        _state[i] = PRESSED;
+        _time[i] = now;
+      }
+      break;
+
+    case PRESSED:
+      if ((!activeLevel) && (elapsed < _debounceTicks)) {
+        // released to quickly, assume bouncing.
+        _state[i] = IDLE;
+
+      } else if (elapsed > _pressTicks) {
+        _dispatch(i, LONG_PRESS_START);
+        _state[i] = LONG;
+        _time[i] = now;
+
+      } else if (!activeLevel) {
+        if (_doubleClick) {
+          _state[i] = RELEASED;
+          _time[i] = now;
+        } else {
+          _dispatch(i, CLICK);
+          _state[i] = IDLE;
+        }
+      }
+      break;
+
+    case RELEASED:
+      if (elapsed > _clickTicks) {
+        // this was only a single short click
+        _dispatch(i, CLICK);
+        _state[i] = IDLE;
+
+      } else if (activeLevel && (elapsed > _debounceTicks)) {
+        _state[i] = PRESSED2;
+        _time[i] = now;
+      }
+      break;
+
+    case PRESSED2:
+      if ((!activeLevel) && (elapsed > _debounceTicks)) {
+        _dispatch(i, DOUBLE_CLICK);
+        _state[i] = IDLE;
+      }
+      break;
+
+    case LONG:
+      if (!activeLevel) {
+        _dispatch(i, LONG_PRESS_STOP);
+        _state[i] = IDLE;
+      }
+      break;
+    } // switch
+  } // for
+} // ButtonBank.tick()
+
+
+// end.
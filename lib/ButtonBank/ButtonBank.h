@@ -0,0 +1,99 @@
+// -----
+// ButtonBank.h - Library for detecting clicks, double clicks and long presses
+// on up to 8 buttons connected to the same port.
+// All buttons are sampled with a single read of the input register and share
+// the timing parameters and one event function. The per button state is
+// packed into 4 bytes, so a front panel with many buttons stays cheap on an
+// ATmega328. The state machine follows the one of OneButton.
+// -----
+// 19.10.2026 created
+// -----
+
+#ifndef ButtonBank_h
+#define ButtonBank_h
+
+#include "Arduino.h"
+
+#define BUTTONBANK_MAX 8
+
+class ButtonBank
+{
+public:
+  enum Event : uint8_t {
+    CLICK = 0,
+    DOUBLE_CLICK = 1,
+    LONG_PRESS_START = 2,
+    LONG_PRESS_STOP = 3
+  };
+
+  // ----- Callback function type -----
+  typedef void (*eventFunction)(uint8_t index, Event event);
+
+  // ----- Constructor -----
+  ButtonBank();
+
+  /**
+   * @brief Add a button to the bank. All buttons must be on the same port.
+   * @return index of the button passed to the event function, -1 when the
+   * bank is full or the pin is on another port.
+   */
+  int8_t addButton(uint8_t pin, bool activeLow = true, bool pullupActive = true);
+
+  // ----- Set runtime parameters -----
+
+  // set # millisec after safe click is assumed.
+  void setDebounceTicks(uint8_t ticks);
+
+  // set # millisec after single click is assumed.
+  void setClickTicks(uint16_t ticks);
+
+  // set # millisec after press is assumed.
+  void setPressTicks(uint16_t ticks);
+
+  // wait for a second click before reporting a click. off by default, so
+  // clicks are reported on release.
+  void setDoubleClick(bool enabled);
+
+  // attach the function called for the events of all buttons.
+  void attachEvent(eventFunction newFunction);
+
+  // ----- State machine functions -----
+
+  /**
+   * @brief Call this function every some milliseconds. Reads the port once
+   * and advances the state machine of every button.
+   */
+  void tick(void);
+
+  bool isLongPressed(uint8_t index);
+  uint8_t getButtonCount();
+
+private:
+  enum State : uint8_t {
+    IDLE = 0,     // waiting for the button being pressed.
+    PRESSED = 1,  // waiting for the button being released.
+    RELEASED = 2, // waiting for the second press or timeout.
+    PRESSED2 = 3, // waiting for the button being released finally.
+    LONG = 4      // waiting for the button being released after long press.
+  };
+
+  void _dispatch(uint8_t index, Event event);
+
+  volatile uint8_t *_pinReg = NULL; // input register of the shared port.
+  uint8_t _invertMask = 0; // bits of the active low buttons.
+  uint8_t _count = 0;
+
+  uint8_t _debounceTicks = 50;
+  uint16_t _clickTicks = 600;
+  uint16_t _pressTicks = 1000;
+  bool _doubleClick = false;
+
+  eventFunction _eventFunc = NULL;
+
+  // per button state
+  uint8_t _mask[BUTTONBANK_MAX]; // bit of the button in the port.
+  State _state[BUTTONBANK_MAX];
+  uint16_t _time[BUTTONBANK_MAX]; // low 16 bits of millis() when the state was entered.
+};
+
+#endif
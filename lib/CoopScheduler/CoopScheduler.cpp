@@ -0,0 +1,203 @@
+// -----
+// CoopScheduler.cpp - Cooperative scheduler running the tasks of a static task
+// table at their declared periods.
+// -----
+// 19.10.2026 created
+// 19.10.2026 low power periods, time until the next task
+// 19.10.2026 run hook for profiling
+// 19.10.2026 breadcrumb of the running task
+// 19.10.2026 CSV export of the worst runtimes and deadline misses
+// -----
+
+#include "CoopScheduler.h"
+
+// ----- Initialization and Default Values -----
+
+CoopScheduler::CoopScheduler(CoopTask *tasks, uint8_t count)
+{
+  _tasks = tasks;
+  _count = count;
+  _lowPower = false;
+  _runHook = NULL;
+  _breadcrumb = NULL;
+  _printLine = 0;
+} // CoopScheduler
+
+
+void CoopScheduler::begin(void)
+{
+  unsigned long now = millis();
+
+  for (uint8_t i = 0; i < _count; i++) {
+    _tasks[i].nextMillis = now;
+  }
+  resetStats();
+} // begin
+
+
+void CoopScheduler::resetStats(void)
+{
+  for (uint8_t i = 0; i < _count; i++) {
+    _tasks[i].worstMicros = 0;
+    _tasks[i].deadlineMisses = 0;
+  }
+} // resetStats
+
+
+void CoopScheduler::attachRunHook(runHookFunction newFunction)
+{
+  _runHook = newFunction;
+} // attachRunHook
+
+
+void CoopScheduler::setBreadcrumb(volatile uint8_t *breadcrumb)
+{
+  _breadcrumb = breadcrumb;
+} // setBreadcrumb
+
+
+uint8_t CoopScheduler::getTaskCount()
+{
+  return _count;
+}
+
+
+const CoopTask &CoopScheduler::getTask(uint8_t index)
+{
+  return _tasks[index];
+}
+
+
+void CoopScheduler::setLowPower(bool lowPower)
+{
+  if (_lowPower && !lowPower) {
+    // leaving low power, do not wait for the long periods to end.
+    unsigned long now = millis();
+
+    for (uint8_t i = 0; i < _count; i++) {
+      _tasks[i].nextMillis = now;
+    }
+  }
+  _lowPower = lowPower;
+} // setLowPower
+
+
+bool CoopScheduler::isLowPower()
+{
+  return _lowPower;
+}
+
+
+inline uint16_t CoopScheduler::_period(const CoopTask &task)
+{
+  if (_lowPower && (task.lowPowerPeriodMillis != 0)) {
+    return task.lowPowerPeriodMillis;
+  }
+  return task.periodMillis;
+}
+
+
+unsigned long CoopScheduler::millisUntilNextTask(void)
+{
+  unsigned long now = millis();
+  unsigned long next = 0xFFFFFFFFUL;
+
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_period(_tasks[i]) == 0) {
+      return 0;
+    }
+
+    long until = (long)(_tasks[i].nextMillis - now);
+    if (until <= 0) {
+      return 0;
+    }
+    if ((unsigned long)until < next) {
+      next = until;
+    }
+  } // for
+  return next;
+} // millisUntilNextTask
+
+
+void CoopScheduler::run(void)
+{
+  unsigned long passStart = micros();
+
+  for (uint8_t i = 0; i < _count; i++) {
+    CoopTask &task = _tasks[i];
+
+    uint16_t period = _period(task);
+
+    if (period != 0) {
+      unsigned long now = millis();
+      long late = (long)(now - task.nextMillis);
+
+      if (late < 0) {
+        // not due yet.
+        continue;
+      }
+
+      if (late >= (long)period) {
+        // a whole period was missed, continue from now instead of
+        // running the task several times to catch up.
+        task.deadlineMisses++;
+        task.nextMillis = now + period;
+      } else {
+        // keep the phase, so the period does not drift.
+        task.nextMillis += period;
+      }
+    }
+
+    if (_breadcrumb) {
+      *_breadcrumb = i;
+    }
+    unsigned long start = micros();
+    task.function();
+    unsigned long runtime = micros() - start;
+
+    if (runtime > task.worstMicros) {
+      task.worstMicros = runtime;
+    }
+    if (_runHook) {
+      _runHook(i, runtime);
+    }
+  } // for
+
+  if (_breadcrumb) {
+    *_breadcrumb = COOPSCHEDULER_NO_TASK;
+  }
+  if (_runHook) {
+    _runHook(_count, micros() - passStart);
+  }
+} // run
+
+
+bool CoopScheduler::printCsvLine(Print &out, const char * const *names)
+{
+  if (_printLine == 0) {
+    out.println(F("task,period_ms,worst_us,deadline_misses"));
+    _printLine = 1;
+    return false;
+  }
+
+  uint8_t i = _printLine - 1;
+  const CoopTask &task = _tasks[i];
+
+  out.print((const __FlashStringHelper *)pgm_read_ptr(&names[i]));
+  out.print(',');
+  out.print(_period(task));
+  out.print(',');
+  out.print(task.worstMicros);
+  out.print(',');
+  out.println(task.deadlineMisses);
+
+  if (++_printLine > _count) {
+    _printLine = 0;
+    resetStats();
+    return true;
+  }
+  return false;
+} // printCsvLine
+
+
+// end.
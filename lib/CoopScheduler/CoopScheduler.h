@@ -0,0 +1,102 @@
+// -----
+// CoopScheduler.h - Cooperative scheduler running the tasks of a static task
+// table at their declared periods.
+// Every task is measured: worst case runtime in microseconds and the number
+// of deadline misses, i.e. how often it was started one whole period late.
+// The table order is the priority order.
+// In low power mode the tasks run at their (longer) low power period, so the
+// controller can sleep between them.
+// -----
+// 19.10.2026 created
+// 19.10.2026 low power periods, time until the next task
+// 19.10.2026 run hook for profiling
+// 19.10.2026 breadcrumb of the running task
+// 19.10.2026 CSV export of the worst runtimes and deadline misses
+// -----
+
+#ifndef CoopScheduler_h
+#define CoopScheduler_h
+
+#include "Arduino.h"
+
+// ----- Task function type -----
+
+extern "C" {
+typedef void (*taskFunction)(void);
+}
+
+// written to the breadcrumb outside of the tasks
+#define COOPSCHEDULER_NO_TASK 0xFF
+
+// called after every task run with the task index and its runtime, and after
+// every pass with the task count as index and the runtime of the pass.
+typedef void (*runHookFunction)(uint8_t index, unsigned long runtimeMicros);
+
+/**
+ * One entry of the task table. Only function, periodMillis and optionally
+ * lowPowerPeriodMillis are declared in the table, the rest is filled in by
+ * the scheduler.
+ */
+struct CoopTask {
+  taskFunction function;
+  uint16_t periodMillis; // 0 runs the task on every pass.
+  uint16_t lowPowerPeriodMillis; // period in low power mode, 0 keeps periodMillis.
+
+  unsigned long nextMillis; // when the task is due next.
+  unsigned long worstMicros; // longest runtime seen.
+  uint16_t deadlineMisses; // starts that were one whole period late.
+};
+
+class CoopScheduler
+{
+public:
+  // ----- Constructor -----
+  CoopScheduler(CoopTask *tasks, uint8_t count);
+
+  // makes all tasks due now. call at the end of setup().
+  void begin(void);
+
+  // runs every due task once, in table order. call from loop().
+  void run(void);
+
+  // clears the runtime measurement and deadline misses.
+  void resetStats(void);
+
+  // switches the tasks to their low power periods.
+  void setLowPower(bool lowPower);
+  bool isLowPower();
+
+  // milliseconds until the next task is due, 0 when one is due now.
+  unsigned long millisUntilNextTask(void);
+
+  // attach a function measuring the runs, e.g. TaskProfiler.
+  void attachRunHook(runHookFunction newFunction);
+
+  // the index of the task entered is written to breadcrumb, and
+  // COOPSCHEDULER_NO_TASK at the end of the pass, e.g. for Watchdog.
+  void setBreadcrumb(volatile uint8_t *breadcrumb);
+
+  uint8_t getTaskCount();
+  const CoopTask &getTask(uint8_t index);
+
+  /**
+   * @brief Print the next line of the CSV frame, header first, then one line
+   * per task: task,period_ms,worst_us,deadline_misses
+   * One line per call keeps the Serial buffer from blocking the tasks.
+   * @param names task names in PROGMEM, same order as the tasks.
+   * @return true when the frame is complete, the statistics are reset then.
+   */
+  bool printCsvLine(Print &out, const char * const *names);
+
+private:
+  uint16_t _period(const CoopTask &task);
+
+  CoopTask *_tasks;
+  uint8_t _count;
+  bool _lowPower;
+  runHookFunction _runHook;
+  volatile uint8_t *_breadcrumb;
+  uint8_t _printLine; // next line of the frame, 0 is the header
+};
+
+#endif
@@ -0,0 +1,226 @@
+// -----
+// DS18B20.cpp - Temperature of a single DS18B20, read in two steps.
+// -----
+// 19.10.2026 created
+// 19.10.2026 power-on value confirmed by a second conversion
+// -----
+
+#include "DS18B20.h"
+#include <util/atomic.h>
+
+#define DS18B20_SKIP_ROM 0xCC
+#define DS18B20_CONVERT_T 0x44
+#define DS18B20_READ_SCRATCHPAD 0xBE
+
+// 85.0 degree, the temperature in the scratchpad after power-on
+#define DS18B20_POWER_ON 0x0550
+
+// ----- Initialization and Default Values -----
+
+DS18B20::DS18B20(uint8_t pin)
+{
+  // The pin is resolved to its registers once. The bus is driven low by
+  // making the pin an output and released by making it an input.
+  _pinReg = portInputRegister(digitalPinToPort(pin));
+  _ddrReg = portModeRegister(digitalPinToPort(pin));
+  _portReg = portOutputRegister(digitalPinToPort(pin));
+  _mask = digitalPinToBitMask(pin);
+
+  _intervalMillis = 60000;
+  _state = IDLE;
+  _stateMillis = 0;
+  _started = false;
+  _temperature = 0;
+  _readMillis = 0;
+  _valid = false;
+  _powerOnRetry = false;
+  _errors = 0;
+} // DS18B20
+
+
+void DS18B20::begin(unsigned long intervalMillis)
+{
+  _intervalMillis = intervalMillis;
+
+  // released, the pull-up holds the bus high
+  *_ddrReg &= ~_mask;
+  *_portReg &= ~_mask;
+} // begin
+
+
+void DS18B20::tick(void)
+{
+  unsigned long now = millis();
+
+  switch (_state) {
+  case IDLE:
+    if (_started && (now - _stateMillis < _intervalMillis))
+      break;
+
+    _started = true;
+    _stateMillis = now;
+    if (_reset()) {
+      _write(DS18B20_SKIP_ROM);
+      _write(DS18B20_CONVERT_T);
+      _state = CONVERTING;
+    } else {
+      _errors++;
+    }
+    break;
+
+  case CONVERTING:
+    if (now - _stateMillis < DS18B20_CONVERSION_MILLIS)
+      break;
+
+    if (_readScratchpad()) {
+      _readMillis = now;
+      _valid = true;
+    } else {
+      _errors++;
+      if (_powerOnRetry)
+        _started = false; // the confirming conversion starts on the next tick
+    }
+    _state = IDLE;
+    break;
+  }
+} // tick()
+
+
+bool DS18B20::isValid(void)
+{
+  return _valid && (millis() - _readMillis < 3 * _intervalMillis);
+}
+
+
+int16_t DS18B20::getTemperature(void)
+{
+  return _temperature;
+}
+
+
+uint16_t DS18B20::getErrors(void)
+{
+  return _errors;
+}
+
+
+// the low part of the reset is not timed critical, only the presence sample is.
+bool DS18B20::_reset(void)
+{
+  // a bus held low has no sensor or a short
+  if (!(*_pinReg & _mask))
+    return false;
+
+  *_ddrReg |= _mask;
+  delayMicroseconds(480);
+
+  bool present;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    *_ddrReg &= ~_mask;
+    delayMicroseconds(70);
+    present = !(*_pinReg & _mask);
+  }
+  delayMicroseconds(410);
+  return present;
+} // _reset
+
+
+void DS18B20::_writeBit(bool bit)
+{
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    *_ddrReg |= _mask;
+    delayMicroseconds(bit ? 10 : 65);
+    *_ddrReg &= ~_mask;
+    delayMicroseconds(bit ? 55 : 5);
+  }
+} // _writeBit
+
+
+bool DS18B20::_readBit(void)
+{
+  bool bit;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    *_ddrReg |= _mask;
+    delayMicroseconds(3);
+    *_ddrReg &= ~_mask;
+    delayMicroseconds(10);
+    bit = *_pinReg & _mask;
+  }
+  delayMicroseconds(53);
+  return bit;
+} // _readBit
+
+
+// least significant bit first
+void DS18B20::_write(uint8_t value)
+{
+  for (uint8_t i = 0; i < 8; i++) {
+    _writeBit(value & 0x01);
+    value >>= 1;
+  }
+} // _write
+
+
+uint8_t DS18B20::_read(void)
+{
+  uint8_t value = 0;
+  for (uint8_t i = 0; i < 8; i++) {
+    value >>= 1;
+    if (_readBit()) {
+      value |= 0x80;
+    }
+  }
+  return value;
+} // _read
+
+
+// all 9 bytes are read for the Dallas CRC-8 in the last one.
+// A sensor which browned out during the conversion returns the power-on
+// value with a valid checksum, so 85.0 degree is only taken when the next
+// conversion reads it again.
+bool DS18B20::_readScratchpad(void)
+{
+  bool confirm = _powerOnRetry;
+  _powerOnRetry = false;
+
+  if (!_reset())
+    return false;
+
+  _write(DS18B20_SKIP_ROM);
+  _write(DS18B20_READ_SCRATCHPAD);
+
+  uint8_t data[9];
+  uint8_t crc = 0;
+  bool zero = true;
+  for (uint8_t i = 0; i < 9; i++) {
+    data[i] = _read();
+    zero = zero && (data[i] == 0);
+
+    if (i < 8) {
+      uint8_t value = data[i];
+      for (uint8_t b = 0; b < 8; b++) {
+        bool mix = (crc ^ value) & 0x01;
+        crc >>= 1;
+        if (mix) {
+          crc ^= 0x8C;
+        }
+        value >>= 1;
+      }
+    }
+  }
+
+  // a released bus reads all ones, and all zeros passes the checksum
+  if ((crc != data[8]) || zero)
+    return false;
+
+  int16_t temperature = (int16_t)((data[1] << 8) | data[0]);
+  if ((temperature == DS18B20_POWER_ON) && !confirm) {
+    _powerOnRetry = true;
+    return false;
+  }
+  _temperature = temperature;
+  return true;
+} // _readScratchpad
+
+
+// end.
@@ -0,0 +1,73 @@
+// -----
+// DS18B20.h - Temperature of a single DS18B20 on a bit-banged 1-Wire bus,
+// read in two steps so the loop never waits for the 750 ms conversion.
+// tick() starts a conversion, and reads the scratchpad on a later tick when
+// the conversion is done. Interrupts are held off only for a single bit slot
+// (at most 70 us) and for the presence sample, so the encoder and the pump
+// timer interrupts are delayed, but never lost.
+// The sensor needs its own supply on VDD, parasite power is not supported.
+// The 85.0 degree power-on value of a sensor which browned out is confirmed
+// by a second conversion before it is taken.
+// -----
+// 19.10.2026 created
+// 19.10.2026 power-on value confirmed by a second conversion
+// -----
+
+#ifndef DS18B20_h
+#define DS18B20_h
+
+#include "Arduino.h"
+
+// 12 bit conversion time
+#define DS18B20_CONVERSION_MILLIS 750
+
+class DS18B20
+{
+public:
+  // ----- Constructor -----
+  // the bus needs a 4.7k pull-up on the pin.
+  DS18B20(uint8_t pin);
+
+  // a conversion is started every intervalMillis.
+  void begin(unsigned long intervalMillis);
+
+  // one step of the reading, takes about 2 ms to start and 7 ms to read.
+  void tick(void);
+
+  // true when the last reading is valid and not older than three intervals.
+  bool isValid(void);
+
+  // last valid temperature in 1/16 degree Celsius.
+  int16_t getTemperature(void);
+
+  // readings without a sensor, with a wrong checksum or the power-on value.
+  uint16_t getErrors(void);
+
+private:
+  enum State { IDLE, CONVERTING };
+
+  bool _reset(void);
+  void _writeBit(bool bit);
+  bool _readBit(void);
+  void _write(uint8_t value);
+  uint8_t _read(void);
+  bool _readScratchpad(void);
+
+  volatile uint8_t *_pinReg;  // input register of the pin.
+  volatile uint8_t *_ddrReg;  // direction register of the pin.
+  volatile uint8_t *_portReg; // output register of the pin.
+  uint8_t _mask;              // bit mask of the pin.
+
+  unsigned long _intervalMillis;
+  State _state;
+  unsigned long _stateMillis;
+  bool _started; // _stateMillis is valid
+
+  int16_t _temperature;
+  unsigned long _readMillis;
+  bool _valid;
+  bool _powerOnRetry; // 85.0 degree was read, the next conversion confirms it
+  uint16_t _errors;
+};
+
+#endif
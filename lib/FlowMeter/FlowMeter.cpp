@@ -0,0 +1,236 @@
+// -----
+// FlowMeter.cpp - Volume of the pump runs from a hall-effect flow sensor.
+// -----
+// 19.10.2026 created
+// 19.10.2026 arithmetic in FlowModel.h
+// 19.10.2026 level sampled in begin()
+// -----
+
+#include "FlowMeter.h"
+#include "FlowModel.h"
+#include <util/atomic.h>
+
+// ----- Initialization and Default Values -----
+
+FlowMeter::FlowMeter(uint8_t pin, uint16_t pulsesPerLitre, flowTargetFunction targetFunction)
+{
+  // The pin is resolved to its input register and bit mask once,
+  // so capture() does not need digitalRead().
+  _pinReg = portInputRegister(digitalPinToPort(pin));
+  _mask = digitalPinToBitMask(pin);
+
+  // open collector output of the sensor, idle high until begin() reads it
+  pinMode(pin, INPUT_PULLUP);
+  _level = true;
+
+  _pulsesPerLitre = pulsesPerLitre;
+  _targetFunction = targetFunction;
+  _pulses = 0;
+  _printLine = 0;
+
+  for (uint8_t i = 0; i < FLOWMETER_CHANNELS; i++) {
+    _startPulses[i] = 0;
+    _targetPulses[i] = 0;
+    _reached[i] = false;
+    _running[i] = false;
+    _runs[i] = 0;
+    _last[i] = 0;
+    _min[i] = 0;
+    _max[i] = 0;
+    _total[i] = 0;
+  }
+} // FlowMeter
+
+
+void FlowMeter::begin(void)
+{
+  // right after enabling the pull-up the input may still read low,
+  // the first interrupt would then count the rise as a pulse.
+  _level = *_pinReg & _mask;
+} // begin
+
+
+void FlowMeter::setCalibration(uint16_t pulsesPerLitre)
+{
+  if (pulsesPerLitre > 0) {
+    _pulsesPerLitre = pulsesPerLitre;
+  }
+}
+
+
+uint16_t FlowMeter::getCalibration(void)
+{
+  return _pulsesPerLitre;
+}
+
+
+void FlowMeter::capture(void)
+{
+  bool level = *_pinReg & _mask;
+  bool pulse = flowIsPulse(_level, level);
+  _level = level;
+  if (!pulse)
+    return;
+
+  _pulses++;
+  for (uint8_t i = 0; i < FLOWMETER_CHANNELS; i++) {
+    if (flowTargetReached(_pulses, _startPulses[i], _targetPulses[i])) {
+      _targetPulses[i] = 0;
+      _reached[i] = true;
+      _targetFunction(i);
+    }
+  }
+} // capture()
+
+
+void FlowMeter::startRun(uint8_t channel, uint32_t targetMillilitres)
+{
+  if (channel >= FLOWMETER_CHANNELS)
+    return;
+
+  uint32_t target = flowTargetPulses(targetMillilitres, _pulsesPerLitre);
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    _startPulses[channel] = _pulses;
+    _targetPulses[channel] = target;
+    _reached[channel] = false;
+  }
+  _running[channel] = true;
+} // startRun
+
+
+uint32_t FlowMeter::endRun(uint8_t channel)
+{
+  if ((channel >= FLOWMETER_CHANNELS) || !_running[channel])
+    return 0;
+
+  uint32_t volume = getRunMillilitres(channel);
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    _targetPulses[channel] = 0;
+  }
+  _running[channel] = false;
+
+  if ((_runs[channel] == 0) || (volume < _min[channel])) {
+    _min[channel] = volume;
+  }
+  if (volume > _max[channel]) {
+    _max[channel] = volume;
+  }
+  if (_runs[channel] < 0xFFFF) {
+    _runs[channel]++;
+  }
+  _last[channel] = volume;
+  _total[channel] += volume;
+  return volume;
+} // endRun
+
+
+bool FlowMeter::takeTargetReached(uint8_t channel)
+{
+  bool reached;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    reached = _reached[channel];
+    _reached[channel] = false;
+  }
+  return reached;
+} // takeTargetReached
+
+
+uint32_t FlowMeter::getRunMillilitres(uint8_t channel)
+{
+  if ((channel >= FLOWMETER_CHANNELS) || !_running[channel])
+    return 0;
+
+  uint32_t pulses;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    pulses = _pulses - _startPulses[channel];
+  }
+  return toMillilitres(pulses);
+} // getRunMillilitres
+
+
+uint16_t FlowMeter::getRuns(uint8_t channel)
+{
+  return _runs[channel];
+}
+
+
+uint32_t FlowMeter::getLastMillilitres(uint8_t channel)
+{
+  return _last[channel];
+}
+
+
+uint32_t FlowMeter::getMinMillilitres(uint8_t channel)
+{
+  return _min[channel];
+}
+
+
+uint32_t FlowMeter::getMaxMillilitres(uint8_t channel)
+{
+  return _max[channel];
+}
+
+
+uint32_t FlowMeter::getTotalMillilitres(uint8_t channel)
+{
+  return _total[channel];
+}
+
+
+uint32_t FlowMeter::getPulses(void)
+{
+  uint32_t pulses;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    pulses = _pulses;
+  }
+  return pulses;
+}
+
+
+uint32_t FlowMeter::toMillilitres(uint32_t pulses)
+{
+  return flowToMillilitres(pulses, _pulsesPerLitre);
+} // toMillilitres
+
+
+uint32_t FlowMeter::toPulses(uint32_t millilitres)
+{
+  return flowToPulses(millilitres, _pulsesPerLitre);
+} // toPulses
+
+
+bool FlowMeter::printCsvLine(Print &out)
+{
+  if (_printLine == 0) {
+    out.println(F("channel,runs,last_ml,min_ml,max_ml,total_ml,pulses"));
+    _printLine = 1;
+    return false;
+  }
+
+  uint8_t i = _printLine - 1;
+
+  out.print(i + 1);
+  out.print(',');
+  out.print(getRuns(i));
+  out.print(',');
+  out.print(getLastMillilitres(i));
+  out.print(',');
+  out.print(getMinMillilitres(i));
+  out.print(',');
+  out.print(getMaxMillilitres(i));
+  out.print(',');
+  out.print(getTotalMillilitres(i));
+  out.print(',');
+  out.println(getPulses());
+
+  if (++_printLine > FLOWMETER_CHANNELS) {
+    _printLine = 0;
+    return true;
+  }
+  return false;
+} // printCsvLine
+
+
+// end.
@@ -0,0 +1,97 @@
+// -----
+// FlowMeter.h - Volume of the pump runs from a hall-effect flow sensor.
+// The pulses are counted by capture() in the pin change interrupt of the
+// sensor pin. A run may have a target volume, the target function is then
+// called from the interrupt at the pulse that reaches it.
+// The sensor sits in the common supply line, every run counts all pulses
+// between its start and its end.
+// -----
+// 19.10.2026 created
+// 19.10.2026 level sampled in begin()
+// -----
+
+#ifndef FlowMeter_h
+#define FlowMeter_h
+
+#include "Arduino.h"
+
+#define FLOWMETER_CHANNELS 2
+
+extern "C" {
+// switches the pump of the channel off, called from the interrupt.
+typedef void (*flowTargetFunction)(uint8_t channel);
+}
+
+class FlowMeter
+{
+public:
+  // ----- Constructor -----
+  // pulsesPerLitre is the calibration of the sensor, about 450 for a YF-S201.
+  FlowMeter(uint8_t pin, uint16_t pulsesPerLitre, flowTargetFunction targetFunction);
+
+  // takes the level of the pin, call before enabling the pin change interrupt.
+  // The pull-up is enabled by the constructor, so the input has settled by setup().
+  void begin(void);
+
+  void setCalibration(uint16_t pulsesPerLitre);
+  uint16_t getCalibration(void);
+
+  // counts a rising edge of the sensor, call from the pin change interrupt.
+  void capture(void);
+
+  // starts counting the run of the channel, call right after switching the relay on.
+  // targetMillilitres of 0 counts only.
+  void startRun(uint8_t channel, uint32_t targetMillilitres);
+
+  // ends the run, its volume goes into the statistics. Returns the volume in ml.
+  uint32_t endRun(uint8_t channel);
+
+  // true once after the run reached its target and the target function was called.
+  bool takeTargetReached(uint8_t channel);
+
+  // volume of the current run in ml.
+  uint32_t getRunMillilitres(uint8_t channel);
+
+  // ----- run statistics since boot, in ml -----
+  uint16_t getRuns(uint8_t channel);
+  uint32_t getLastMillilitres(uint8_t channel);
+  uint32_t getMinMillilitres(uint8_t channel);
+  uint32_t getMaxMillilitres(uint8_t channel);
+  uint32_t getTotalMillilitres(uint8_t channel);
+
+  // all pulses since boot.
+  uint32_t getPulses(void);
+
+  uint32_t toMillilitres(uint32_t pulses);
+  uint32_t toPulses(uint32_t millilitres);
+
+  /**
+   * @brief Prints one line of the statistics as CSV, the header first.
+   * Returns true after the last line.
+   */
+  bool printCsvLine(Print &out);
+
+private:
+  volatile uint8_t *_pinReg; // input register of the sensor pin.
+  uint8_t _mask;             // bit mask of the sensor pin.
+  volatile bool _level;
+
+  uint16_t _pulsesPerLitre;
+  flowTargetFunction _targetFunction;
+
+  volatile uint32_t _pulses;
+  volatile uint32_t _startPulses[FLOWMETER_CHANNELS];
+  volatile uint32_t _targetPulses[FLOWMETER_CHANNELS]; // 0 when there is no target
+  volatile bool _reached[FLOWMETER_CHANNELS];
+  bool _running[FLOWMETER_CHANNELS];
+
+  uint16_t _runs[FLOWMETER_CHANNELS];
+  uint32_t _last[FLOWMETER_CHANNELS];
+  uint32_t _min[FLOWMETER_CHANNELS];
+  uint32_t _max[FLOWMETER_CHANNELS];
+  uint32_t _total[FLOWMETER_CHANNELS];
+
+  uint8_t _printLine;
+};
+
+#endif
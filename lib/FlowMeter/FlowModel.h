@@ -0,0 +1,52 @@
+// -----
+// FlowModel.h - Pulse and volume arithmetic of FlowMeter.
+// Plain integer arithmetic without hardware access, so it can be compiled
+// and checked on the host.
+// -----
+// 19.10.2026 created
+// -----
+
+#ifndef FlowModel_h
+#define FlowModel_h
+
+#include <stdint.h>
+
+// true for a rising edge of the sensor. The pin change interrupt is shared
+// with other pins, so an unchanged level is no edge.
+inline bool flowIsPulse(bool previousLevel, bool level)
+{
+  return level && !previousLevel;
+}
+
+// split in whole litres and the rest, so the 32 bit product cannot overflow
+inline uint32_t flowToMillilitres(uint32_t pulses, uint16_t pulsesPerLitre)
+{
+  return (pulses / pulsesPerLitre) * 1000
+    + (pulses % pulsesPerLitre) * 1000UL / pulsesPerLitre;
+}
+
+inline uint32_t flowToPulses(uint32_t millilitres, uint16_t pulsesPerLitre)
+{
+  return (millilitres / 1000) * pulsesPerLitre
+    + (millilitres % 1000) * (uint32_t)pulsesPerLitre / 1000;
+}
+
+// pulses of a target volume, 0 for no target. A target below one pulse
+// stops at the first pulse.
+inline uint32_t flowTargetPulses(uint32_t targetMillilitres, uint16_t pulsesPerLitre)
+{
+  uint32_t target = flowToPulses(targetMillilitres, pulsesPerLitre);
+  if ((targetMillilitres > 0) && (target == 0)) {
+    target = 1;
+  }
+  return target;
+}
+
+// the run started at startPulses reached its target, also across the
+// overflow of the pulse counter.
+inline bool flowTargetReached(uint32_t pulses, uint32_t startPulses, uint32_t targetPulses)
+{
+  return (targetPulses != 0) && (pulses - startPulses >= targetPulses);
+}
+
+#endif
@@ -0,0 +1,162 @@
+// -----
+// JitterMonitor.cpp - Offset between the scheduled time of an event and the
+// moment it really happened.
+// -----
+// 19.10.2026 created
+// -----
+
+#include "JitterMonitor.h"
+
+// ----- Initialization and Default Values -----
+
+JitterMonitor::JitterMonitor()
+{
+  _printLine = 0;
+  reset();
+} // JitterMonitor
+
+
+void JitterMonitor::reset(void)
+{
+  memset(_channels, 0, sizeof(_channels));
+  for (uint8_t i = 0; i < JITTERMONITOR_CHANNELS; i++) {
+    _channels[i].minMillis = 0xFFFF;
+  }
+} // reset
+
+
+void JitterMonitor::expect(uint8_t channel, unsigned long scheduledMillis)
+{
+  if (channel >= JITTERMONITOR_CHANNELS)
+    return;
+
+  _channels[channel].pending = true;
+  _channels[channel].scheduledMillis = scheduledMillis;
+} // expect
+
+
+bool JitterMonitor::edge(uint8_t channel, unsigned long edgeMillis)
+{
+  if (channel >= JITTERMONITOR_CHANNELS)
+    return false;
+
+  Channel &c = _channels[channel];
+  if (!c.pending)
+    return false; // not scheduled, e.g. a manual run
+
+  c.pending = false;
+
+  unsigned long elapsed = edgeMillis - c.scheduledMillis;
+  uint16_t offset = (elapsed > 0xFFFE) ? 0xFFFE : elapsed;
+
+  if (c.count < 0xFFFF)
+    c.count++;
+  if (offset < c.minMillis)
+    c.minMillis = offset;
+  if (offset > c.maxMillis)
+    c.maxMillis = offset;
+
+  uint8_t bin = 0;
+  for (uint16_t limit = 16; (offset >= limit) && (bin < JITTERMONITOR_BINS - 1); limit <<= 1)
+    bin++;
+  if (c.bins[bin] < 0xFFFF)
+    c.bins[bin]++;
+  return true;
+} // edge
+
+
+void JitterMonitor::cancel(uint8_t channel)
+{
+  if (channel >= JITTERMONITOR_CHANNELS)
+    return;
+
+  _channels[channel].pending = false;
+} // cancel
+
+
+void JitterMonitor::miss(uint8_t channel)
+{
+  if (channel >= JITTERMONITOR_CHANNELS)
+    return;
+
+  _channels[channel].pending = false;
+  if (_channels[channel].missed < 0xFFFF)
+    _channels[channel].missed++;
+} // miss
+
+
+uint16_t JitterMonitor::getCount(uint8_t channel)
+{
+  return _channels[channel].count;
+}
+
+uint16_t JitterMonitor::getMinMillis(uint8_t channel)
+{
+  return _channels[channel].count ? _channels[channel].minMillis : 0;
+}
+
+uint16_t JitterMonitor::getMaxMillis(uint8_t channel)
+{
+  return _channels[channel].maxMillis;
+}
+
+uint16_t JitterMonitor::getMissed(uint8_t channel)
+{
+  return _channels[channel].missed;
+}
+
+
+uint16_t JitterMonitor::getPercentileMillis(uint8_t channel, uint8_t percent)
+{
+  Channel &c = _channels[channel];
+  if (c.count == 0)
+    return 0;
+
+  // samples at or below the percentile, rounded up
+  uint32_t rank = ((uint32_t)c.count * percent + 99) / 100;
+  uint32_t seen = 0;
+
+  for (uint8_t bin = 0; bin < JITTERMONITOR_BINS - 1; bin++) {
+    seen += c.bins[bin];
+    if (seen >= rank)
+      return 16 << bin;
+  }
+  return JITTERMONITOR_OVERFLOW;
+} // getPercentileMillis
+
+
+bool JitterMonitor::printCsvLine(Print &out)
+{
+  if (_printLine == 0) {
+    out.println(F("channel,count,min_ms,max_ms,p50_ms,p90_ms,p99_ms,missed"));
+    _printLine = 1;
+    return false;
+  }
+
+  uint8_t i = _printLine - 1;
+
+  out.print(i + 1);
+  out.print(',');
+  out.print(getCount(i));
+  out.print(',');
+  out.print(getMinMillis(i));
+  out.print(',');
+  out.print(getMaxMillis(i));
+  out.print(',');
+  out.print(getPercentileMillis(i, 50));
+  out.print(',');
+  out.print(getPercentileMillis(i, 90));
+  out.print(',');
+  out.print(getPercentileMillis(i, 99));
+  out.print(',');
+  out.println(getMissed(i));
+
+  if (++_printLine > JITTERMONITOR_CHANNELS) {
+    _printLine = 0;
+    return true;
+  }
+  return false;
+} // printCsvLine
+
+
+// end.
@@ -0,0 +1,74 @@
+// -----
+// JitterMonitor.h - Offset between the scheduled time of an event and the
+// moment it really happened, in milliseconds, with min/max, percentiles from
+// a log2 histogram and a counter of missed events per channel.
+// -----
+// 19.10.2026 created
+// -----
+
+#ifndef JitterMonitor_h
+#define JitterMonitor_h
+
+#include "Arduino.h"
+
+#define JITTERMONITOR_CHANNELS 2
+
+// bin 0 counts offsets below 16 ms, bin k below 16 << k ms,
+// the last bin counts everything from 1024 ms on.
+#define JITTERMONITOR_BINS 8
+
+// returned by getPercentileMillis() when the percentile is in the last bin
+#define JITTERMONITOR_OVERFLOW 0xFFFF
+
+class JitterMonitor
+{
+public:
+  // ----- Constructor -----
+  JitterMonitor();
+
+  // the next edge of the channel should have happened at scheduledMillis.
+  void expect(uint8_t channel, unsigned long scheduledMillis);
+
+  // the channel really switched, records the offset to the expected time.
+  // returns true when the edge was expected.
+  bool edge(uint8_t channel, unsigned long edgeMillis);
+
+  // the expected edge will not come, e.g. the pump was stopped by hand.
+  void cancel(uint8_t channel);
+
+  // the scheduled event did not happen at all.
+  void miss(uint8_t channel);
+
+  void reset(void);
+
+  uint16_t getCount(uint8_t channel);
+  uint16_t getMinMillis(uint8_t channel);
+  uint16_t getMaxMillis(uint8_t channel);
+  uint16_t getMissed(uint8_t channel);
+
+  // upper bound of the bin holding the percentile, 0 without samples.
+  uint16_t getPercentileMillis(uint8_t channel, uint8_t percent);
+
+  /**
+   * @brief Print the next line of the CSV frame, header first, then one line
+   * per channel: channel,count,min_ms,max_ms,p50_ms,p90_ms,p99_ms,missed
+   * @return true when the frame is complete.
+   */
+  bool printCsvLine(Print &out);
+
+private:
+  struct Channel {
+    bool pending;
+    unsigned long scheduledMillis;
+    uint16_t count;
+    uint16_t minMillis;
+    uint16_t maxMillis;
+    uint16_t missed;
+    uint16_t bins[JITTERMONITOR_BINS];
+  };
+
+  Channel _channels[JITTERMONITOR_CHANNELS];
+  uint8_t _printLine; // next line of the frame, 0 is the header
+};
+
+#endif
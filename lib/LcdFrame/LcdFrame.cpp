@@ -0,0 +1,101 @@
+#include "LcdFrame.h"
+#include <string.h>
+
+#define LCDFRAME_SIZE (LCDFRAME_ROWS * LCDFRAME_COLS)
+#define LCDFRAME_NOPOS 0xFF
+
+LcdFrame::LcdFrame(LiquidCrystal_I2C &lcd) : _lcd(lcd)
+{
+	memset(_frame, ' ', LCDFRAME_SIZE);
+	memset(_shown, ' ', LCDFRAME_SIZE); // the display is cleared by begin()
+	_col = 0;
+	_row = 0;
+	_lcdPos = LCDFRAME_NOPOS; // createChar() leaves the address counter in CGRAM
+	_cursor = false;
+	_shownCursor = false;
+}
+
+void LcdFrame::clear() {
+	memset(_frame, ' ', LCDFRAME_SIZE);
+	home();
+}
+
+void LcdFrame::home() {
+	_col = 0;
+	_row = 0;
+}
+
+void LcdFrame::setCursor(uint8_t col, uint8_t row) {
+	if (row >= LCDFRAME_ROWS) {
+		row = LCDFRAME_ROWS - 1;    // we count rows starting w/0
+	}
+	_col = col;
+	_row = row;
+}
+
+size_t LcdFrame::write(uint8_t value) {
+	// characters past the end of the line are not visible
+	if (_col < LCDFRAME_COLS) {
+		_frame[_row * LCDFRAME_COLS + _col] = value;
+	}
+	_col++;
+	return 1;
+}
+
+void LcdFrame::cursor() {
+	_cursor = true;
+}
+
+void LcdFrame::noCursor() {
+	_cursor = false;
+}
+
+void LcdFrame::invalidate() {
+	for (uint8_t i = 0; i < LCDFRAME_SIZE; i++) {
+		_shown[i] = ~_frame[i];
+	}
+	_lcdPos = LCDFRAME_NOPOS;
+	_shownCursor = !_cursor;
+}
+
+bool LcdFrame::flush(uint8_t maxWrites) {
+	for (uint8_t i = 0; i < LCDFRAME_SIZE; i++) {
+		if (_frame[i] == _shown[i]) {
+			continue;
+		}
+		if (maxWrites == 0) {
+			return false;
+		}
+
+		// the display moves its cursor by itself when characters follow each other
+		if (_lcdPos != i) {
+			_lcd.setCursor(i % LCDFRAME_COLS, i / LCDFRAME_COLS);
+		}
+		_lcd.write(_frame[i]);
+		_shown[i] = _frame[i];
+		maxWrites--;
+
+		// the next line does not follow in the display memory
+		_lcdPos = ((i + 1) % LCDFRAME_COLS == 0) ? LCDFRAME_NOPOS : i + 1;
+	}
+
+	if (_cursor != _shownCursor) {
+		if (_cursor) {
+			_lcd.cursor();
+		} else {
+			_lcd.noCursor();
+		}
+		_shownCursor = _cursor;
+	}
+
+	// with the cursor shown, it must stay where the frame cursor is
+	if (_cursor && (_col < LCDFRAME_COLS)) {
+		uint8_t pos = _row * LCDFRAME_COLS + _col;
+		if (_lcdPos != pos) {
+			_lcd.setCursor(_col, _row);
+			_lcdPos = pos;
+		}
+	}
+
+	return true;
+}
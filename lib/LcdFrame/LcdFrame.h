@@ -0,0 +1,74 @@
+#ifndef LCD_FRAME_H
+#define LCD_FRAME_H
+
+#include <inttypes.h>
+#include <Print.h>
+#include <LiquidCrystal_I2C.h>
+
+#define LCDFRAME_COLS 16
+#define LCDFRAME_ROWS 2
+
+/**
+ * Frame buffer in front of a LiquidCrystal_I2C display.
+ *
+ * Drawing (clear, setCursor, print, cursor) only changes memory, so it never waits
+ * for the I2C bus or the display. flush() copies the changed characters to the
+ * display, at most a given number per call, so a screen redraw is spread over
+ * several short steps and unchanged characters are not sent at all.
+ */
+class LcdFrame : public Print {
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param lcd	Display the frame is flushed to.
+	 */
+	LcdFrame(LiquidCrystal_I2C &lcd);
+
+	/**
+	 * Fill the frame with spaces and move the cursor to the first position.
+	 */
+	void clear();
+
+	/**
+	 * Move the cursor to the first position.
+	 */
+	void home();
+
+	void setCursor(uint8_t col, uint8_t row);
+	virtual size_t write(uint8_t);
+
+	/**
+	 * Show or hide the cursor indicator of the display after the frame is flushed.
+	 */
+	void cursor();
+	void noCursor();
+
+	inline void cursor_on() { cursor(); }
+	inline void cursor_off() { noCursor(); }
+
+	/**
+	 * Send at most maxWrites changed characters to the display, followed by the cursor
+	 * commands once all characters are sent.
+	 *
+	 * @return true when the display shows the whole frame and the cursor is in place.
+	 */
+	bool flush(uint8_t maxWrites);
+
+	/**
+	 * Send the whole frame again, e.g. after the display was reinitialized.
+	 */
+	void invalidate();
+
+private:
+	LiquidCrystal_I2C &_lcd;
+	uint8_t _frame[LCDFRAME_ROWS * LCDFRAME_COLS]; // what should be shown
+	uint8_t _shown[LCDFRAME_ROWS * LCDFRAME_COLS]; // what the display shows
+	uint8_t _col;
+	uint8_t _row;
+	uint8_t _lcdPos; // address of the display cursor, LCDFRAME_NOPOS when unknown
+	bool _cursor;
+	bool _shownCursor;
+};
+
+#endif // LCD_FRAME_H
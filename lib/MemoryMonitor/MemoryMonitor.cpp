@@ -0,0 +1,147 @@
+// -----
+// MemoryMonitor.cpp - SRAM budget of the ATmega328.
+// -----
+// 19.10.2026 created
+// 19.10.2026 canary searched from the stack side
+// -----
+
+#include "MemoryMonitor.h"
+
+// symbols of the linker and of malloc() in avr-libc
+extern uint8_t __heap_start;
+extern uint8_t *__brkval;
+extern size_t __malloc_margin;
+
+struct __freelist {
+  size_t sz;
+  struct __freelist *nx;
+};
+extern struct __freelist *__flp;
+
+
+// Paints all SRAM above the static data before main(), runs after the stack
+// pointer is set and before the global constructors. No stack is used.
+void memoryMonitorPaint(void) __attribute__((naked, used, section(".init3")));
+
+void memoryMonitorPaint(void)
+{
+  uint8_t *p = &__heap_start;
+
+  while (p <= (uint8_t *)RAMEND) {
+    *p++ = MEMORYMONITOR_CANARY;
+  }
+} // memoryMonitorPaint
+
+
+// end of the heap, __brkval is 0 until the first malloc().
+static uint16_t heapBreak(void)
+{
+  return (__brkval == 0) ? (uint16_t)(uintptr_t)&__heap_start : (uint16_t)(uintptr_t)__brkval;
+} // heapBreak
+
+
+// ----- Initialization and Default Values -----
+
+MemoryMonitor::MemoryMonitor(uint16_t alarmBytes)
+{
+  _alarmBytes = alarmBytes;
+  _heapTop = (uint16_t)(uintptr_t)&__heap_start;
+  _canaryEnd = RAMEND + 1;
+  _alarm = false;
+  _printHeader = true;
+} // MemoryMonitor
+
+
+void MemoryMonitor::update(void)
+{
+  uint16_t brk = heapBreak();
+  if (brk > _heapTop) {
+    _heapTop = brk; // memory given back by malloc() is not painted again
+  }
+
+  // The canary is searched from the stack side: free() lowers the break, so
+  // the bytes above it are written but no longer part of the heap. Below the
+  // deepest stack byte so far, the written bytes go on until a run of canary
+  // bytes, a single canary value can also be a byte of a stack frame.
+  uint16_t start = (SP < _canaryEnd) ? SP : _canaryEnd;
+  uint8_t *low = (uint8_t *)(uintptr_t)brk;
+  uint8_t *p = (uint8_t *)(uintptr_t)start;
+  uint8_t run = 0;
+  while ((p > low) && (run < MEMORYMONITOR_CANARY_RUN)) {
+    p--;
+    run = (*p == MEMORYMONITOR_CANARY) ? run + 1 : 0;
+  }
+  _canaryEnd = (uint16_t)(uintptr_t)(p + run);
+
+  _alarm = (getStackHeadroom() < _alarmBytes);
+} // update
+
+
+uint16_t MemoryMonitor::getStackHeadroom(void)
+{
+  return (_canaryEnd > _heapTop) ? _canaryEnd - _heapTop : 0;
+}
+
+uint16_t MemoryMonitor::getStackHighWater(void)
+{
+  return RAMEND + 1 - _canaryEnd;
+}
+
+uint16_t MemoryMonitor::getHeapBreak(void)
+{
+  return heapBreak();
+}
+
+uint16_t MemoryMonitor::getFreeNow(void)
+{
+  return SP - heapBreak();
+}
+
+
+uint16_t MemoryMonitor::getLargestFreeBlock(void)
+{
+  // malloc() keeps __malloc_margin bytes free for the stack
+  uint16_t gap = SP - heapBreak();
+  uint16_t largest = (gap > __malloc_margin) ? gap - __malloc_margin : 0;
+
+  for (struct __freelist *fp = __flp; fp; fp = fp->nx) {
+    if (fp->sz > largest) {
+      largest = fp->sz;
+    }
+  }
+  return largest;
+} // getLargestFreeBlock
+
+
+bool MemoryMonitor::isAlarm(void)
+{
+  return _alarm;
+}
+
+
+bool MemoryMonitor::printCsvLine(Print &out)
+{
+  if (_printHeader) {
+    out.println(F("headroom,stack_max,heap_break,free,largest_block,alarm"));
+    _printHeader = false;
+    return false;
+  }
+
+  out.print(getStackHeadroom());
+  out.print(',');
+  out.print(getStackHighWater());
+  out.print(',');
+  out.print(getHeapBreak());
+  out.print(',');
+  out.print(getFreeNow());
+  out.print(',');
+  out.print(getLargestFreeBlock());
+  out.print(',');
+  out.println(_alarm ? 1 : 0);
+
+  _printHeader = true;
+  return true;
+} // printCsvLine
+
+
+// end.
@@ -0,0 +1,68 @@
+// -----
+// MemoryMonitor.h - SRAM budget of the ATmega328: the free RAM between heap
+// and stack is painted with a canary at boot, so the deepest stack ever used
+// can be found later. Reports the stack high-water mark, heap break and the
+// largest free block, with an alarm when the headroom gets low.
+// -----
+// 19.10.2026 created
+// 19.10.2026 canary searched from the stack side
+// -----
+
+#ifndef MemoryMonitor_h
+#define MemoryMonitor_h
+
+#include "Arduino.h"
+
+// value painted over the free SRAM before main()
+#define MEMORYMONITOR_CANARY 0xC5
+
+// canary bytes in a row that end the written part of the stack
+#define MEMORYMONITOR_CANARY_RUN 8
+
+// headroom of the stack in bytes below which isAlarm() is set
+#define MEMORYMONITOR_ALARM_BYTES 128
+
+class MemoryMonitor
+{
+public:
+  // ----- Constructor -----
+  MemoryMonitor(uint16_t alarmBytes = MEMORYMONITOR_ALARM_BYTES);
+
+  // scans the canary below the deepest stack so far, a few microseconds
+  // unless the stack grew, call this function every some seconds.
+  void update(void);
+
+  // bytes between the heap and the deepest stack ever, never written since boot.
+  uint16_t getStackHeadroom(void);
+
+  // most bytes the stack ever used.
+  uint16_t getStackHighWater(void);
+
+  // end of the heap, address of the first byte not used by malloc().
+  uint16_t getHeapBreak(void);
+
+  // bytes between the heap and the stack right now.
+  uint16_t getFreeNow(void);
+
+  // largest block malloc() could return right now.
+  uint16_t getLargestFreeBlock(void);
+
+  // headroom was below the alarm threshold at the last update().
+  bool isAlarm(void);
+
+  /**
+   * @brief Print the next line of the CSV frame, header first:
+   * headroom,stack_max,heap_break,free,largest_block,alarm
+   * @return true when the frame is complete.
+   */
+  bool printCsvLine(Print &out);
+
+private:
+  uint16_t _alarmBytes;
+  uint16_t _heapTop;    // highest heap break seen
+  uint16_t _canaryEnd;  // first byte of the canary written by the stack
+  bool _alarm;
+  bool _printHeader;
+};
+
+#endif
@@ -0,0 +1,70 @@
+// -----
+// MoistureModel.h - Filter and percent mapping of MoistureSensors.
+// Plain integer arithmetic without hardware access, so it can be compiled
+// and checked on the host.
+// -----
+// 19.10.2026 created
+// -----
+
+#ifndef MoistureModel_h
+#define MoistureModel_h
+
+#include <stdint.h>
+
+// weight of a new reading in the average is 1/2^n
+#define MOISTURESENSORS_EMA_SHIFT 2
+
+// readings this close to the rails mean a missing probe
+#define MOISTURESENSORS_RAIL 16
+#define MOISTURESENSORS_FULL_SCALE 8191
+
+struct MoistureFilter {
+  uint16_t ema; // filtered reading << MOISTURESENSORS_EMA_SHIFT
+  bool valid;   // the last reading was plausible
+  bool seeded;  // ema holds a reading
+};
+
+inline void moistureFilterReset(MoistureFilter &filter)
+{
+  filter.ema = 0;
+  filter.valid = false;
+  filter.seeded = false;
+}
+
+/**
+ * @brief Feeds one 13 bit reading into the exponential moving average.
+ * A reading near the rails is invalid and restarts the average, the first
+ * valid reading after it seeds the average.
+ */
+inline void moistureFilterUpdate(MoistureFilter &filter, uint16_t reading)
+{
+  filter.valid = (reading > MOISTURESENSORS_RAIL) && (reading < MOISTURESENSORS_FULL_SCALE - MOISTURESENSORS_RAIL);
+  if (!filter.valid) {
+    filter.seeded = false;
+  } else if (!filter.seeded) {
+    filter.ema = reading << MOISTURESENSORS_EMA_SHIFT;
+    filter.seeded = true;
+  } else {
+    filter.ema = filter.ema - (filter.ema >> MOISTURESENSORS_EMA_SHIFT) + reading;
+  }
+}
+
+// filtered reading in 13 bit.
+inline uint16_t moistureFilterRaw(const MoistureFilter &filter)
+{
+  return filter.ema >> MOISTURESENSORS_EMA_SHIFT;
+}
+
+// moisture of a reading, 0 at dryRaw to 100 at wetRaw, clamped outside.
+inline uint8_t moisturePercent(uint16_t raw, uint16_t dryRaw, uint16_t wetRaw)
+{
+  int32_t percent = ((int32_t)raw - dryRaw) * 100 / ((int32_t)wetRaw - dryRaw);
+
+  if (percent < 0)
+    return 0;
+  if (percent > 100)
+    return 100;
+  return percent;
+}
+
+#endif
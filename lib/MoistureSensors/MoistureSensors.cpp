@@ -0,0 +1,205 @@
+// -----
+// MoistureSensors.cpp - Soil moisture probes sampled by the ADC in
+// free-running mode.
+// -----
+// 19.10.2026 created
+// 19.10.2026 filter and percent in MoistureModel.h
+// -----
+
+#include "MoistureSensors.h"
+#include <avr/power.h>
+
+// a window is given up when the ADC does not finish in time
+#define MOISTURESENSORS_TIMEOUT_MILLIS 100
+
+static MoistureSensors *moistureSensors = NULL;
+
+ISR(ADC_vect)
+{
+  if (moistureSensors) {
+    moistureSensors->sample(ADC);
+  }
+}
+
+
+// ----- Initialization and Default Values -----
+
+MoistureSensors::MoistureSensors(const uint8_t *pins, uint8_t count, uint8_t powerPin)
+{
+  _pins = pins;
+  _count = (count > MOISTURESENSORS_MAX) ? MOISTURESENSORS_MAX : count;
+  _powerPin = powerPin;
+
+  _intervalMillis = 60000;
+  _settleMillis = 100;
+  _dryRaw = MOISTURESENSORS_FULL_SCALE;
+  _wetRaw = 0;
+
+  _state = IDLE;
+  _stateMillis = 0;
+  _windowMillis = 0;
+  _measured = false;
+
+  _channel = 0;
+  _discard = 0;
+  _samples = 0;
+  _sum = 0;
+  _done = false;
+  _readings = 0;
+
+  for (uint8_t i = 0; i < MOISTURESENSORS_MAX; i++) {
+    _reading[i] = 0;
+    moistureFilterReset(_filter[i]);
+  }
+} // MoistureSensors
+
+
+void MoistureSensors::begin(unsigned long intervalMillis, uint16_t settleMillis)
+{
+  moistureSensors = this;
+  _intervalMillis = intervalMillis;
+  _settleMillis = settleMillis;
+
+  digitalWrite(_powerPin, LOW);
+  pinMode(_powerPin, OUTPUT);
+
+  // A0-A5 have a digital input buffer, it only costs current on an analog level
+  for (uint8_t i = 0; i < _count; i++) {
+    uint8_t channel = _pins[i] - A0;
+    if (channel < 6) {
+      DIDR0 |= _BV(channel);
+    }
+  }
+} // begin
+
+
+void MoistureSensors::setCalibration(uint16_t dryRaw, uint16_t wetRaw)
+{
+  if (dryRaw != wetRaw) {
+    _dryRaw = dryRaw;
+    _wetRaw = wetRaw;
+  }
+} // setCalibration
+
+
+void MoistureSensors::tick(void)
+{
+  unsigned long now = millis();
+
+  switch (_state) {
+  case IDLE:
+    if (!_measured || (now - _windowMillis >= _intervalMillis)) {
+      digitalWrite(_powerPin, HIGH);
+      _windowMillis = now;
+      _measured = true;
+      _stateMillis = now;
+      _state = SETTLING;
+    }
+    break;
+
+  case SETTLING:
+    if (now - _stateMillis >= _settleMillis) {
+      _startAdc();
+      _stateMillis = now;
+      _state = SAMPLING;
+    }
+    break;
+
+  case SAMPLING:
+    if (_done) {
+      _stop();
+      for (uint8_t i = 0; i < _count; i++) {
+        moistureFilterUpdate(_filter[i], _reading[i]);
+      }
+      _readings++;
+    } else if (now - _stateMillis >= MOISTURESENSORS_TIMEOUT_MILLIS) {
+      _stop();
+    }
+    break;
+  }
+} // tick()
+
+
+// free-running conversions at 125 kHz ADC clock, about 9.6 kHz.
+void MoistureSensors::_startAdc(void)
+{
+  power_adc_enable();
+
+  _channel = 0;
+  _samples = 0;
+  _sum = 0;
+  _done = false;
+  // the first conversion charges the reference
+  _discard = 2;
+
+  ADMUX = _BV(REFS0) | ((_pins[0] - A0) & 0x07); // AVcc reference
+  ADCSRB = 0; // free running
+  ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIF) | _BV(ADIE)
+    | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+} // _startAdc
+
+
+void MoistureSensors::_stop(void)
+{
+  ADCSRA = 0;
+  power_adc_disable();
+  digitalWrite(_powerPin, LOW);
+  _state = IDLE;
+} // _stop
+
+
+void MoistureSensors::sample(uint16_t value)
+{
+  if (_discard) {
+    _discard--;
+    return;
+  }
+
+  _sum += value;
+  if (++_samples < MOISTURESENSORS_SAMPLES)
+    return;
+
+  _reading[_channel] = _sum >> MOISTURESENSORS_SHIFT;
+  _sum = 0;
+  _samples = 0;
+
+  if (++_channel < _count) {
+    // the running conversion still uses the old channel, the one after
+    // that settles on the new one
+    ADMUX = _BV(REFS0) | ((_pins[_channel] - A0) & 0x07);
+    _discard = 2;
+  } else {
+    ADCSRA = 0;
+    _done = true;
+  }
+} // sample()
+
+
+bool MoistureSensors::isValid(uint8_t channel)
+{
+  return (channel < _count) && _filter[channel].valid;
+}
+
+
+uint16_t MoistureSensors::getRaw(uint8_t channel)
+{
+  if (channel >= _count)
+    return 0;
+
+  return moistureFilterRaw(_filter[channel]);
+} // getRaw
+
+
+uint8_t MoistureSensors::getPercent(uint8_t channel)
+{
+  return moisturePercent(getRaw(channel), _dryRaw, _wetRaw);
+} // getPercent
+
+
+uint16_t MoistureSensors::getReadings(void)
+{
+  return _readings;
+}
+
+
+// end.
@@ -0,0 +1,90 @@
+// -----
+// MoistureSensors.h - Soil moisture probes sampled by the ADC in free-running
+// mode, without blocking the loop.
+// The probes are powered only for a short measurement window, which slows
+// down their corrosion. tick() switches the power on, waits for the probes to
+// settle and starts the ADC. The ADC interrupt oversamples every probe and
+// switches to the next one. tick() then powers everything off and feeds the
+// readings into an exponential moving average.
+// Readings are in 13 bit (64 samples of 10 bit), the percent is 0 for a dry
+// and 100 for a wet probe, see setCalibration().
+// -----
+// 19.10.2026 created
+// 19.10.2026 filter and percent in MoistureModel.h
+// -----
+
+#ifndef MoistureSensors_h
+#define MoistureSensors_h
+
+#include "Arduino.h"
+#include "MoistureModel.h"
+
+#define MOISTURESENSORS_MAX 4
+
+// 64 samples add 3 bits to the 10 bit ADC
+#define MOISTURESENSORS_SAMPLES 64
+#define MOISTURESENSORS_SHIFT 3
+
+class MoistureSensors
+{
+public:
+  // ----- Constructor -----
+  // pins are the analog inputs of the probes, e.g. A6.
+  MoistureSensors(const uint8_t *pins, uint8_t count, uint8_t powerPin);
+
+  // probes are powered and measured every intervalMillis, after settleMillis.
+  void begin(unsigned long intervalMillis, uint16_t settleMillis);
+
+  // raw readings of a dry and a wet probe, capacitive probes read lower when wet.
+  void setCalibration(uint16_t dryRaw, uint16_t wetRaw);
+
+  // runs the measurement window, call every 100 ms or faster.
+  void tick(void);
+
+  // true when the probe gave a plausible reading.
+  bool isValid(uint8_t channel);
+
+  // filtered reading in 13 bit.
+  uint16_t getRaw(uint8_t channel);
+
+  // filtered moisture, 0 dry to 100 wet.
+  uint8_t getPercent(uint8_t channel);
+
+  // finished measurement windows.
+  uint16_t getReadings(void);
+
+  // called by the ADC interrupt with every conversion.
+  void sample(uint16_t value);
+
+private:
+  enum State { IDLE, SETTLING, SAMPLING };
+
+  void _startAdc(void);
+  void _stop(void);
+
+  const uint8_t *_pins;
+  uint8_t _count;
+  uint8_t _powerPin;
+
+  unsigned long _intervalMillis;
+  uint16_t _settleMillis;
+  uint16_t _dryRaw, _wetRaw;
+
+  State _state;
+  unsigned long _stateMillis;
+  unsigned long _windowMillis;
+  bool _measured; // _windowMillis is valid
+
+  // written by the ADC interrupt
+  volatile uint8_t _channel;
+  volatile uint8_t _discard;
+  volatile uint8_t _samples;
+  volatile uint16_t _sum;
+  volatile uint16_t _reading[MOISTURESENSORS_MAX];
+  volatile bool _done;
+
+  MoistureFilter _filter[MOISTURESENSORS_MAX];
+  uint16_t _readings;
+};
+
+#endif
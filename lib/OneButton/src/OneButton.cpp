@@ -32,6 +32,8 @@ OneButton::OneButton(int pin, int activeLow, bool pullupActive)
 {
   // OneButton();
   _pin = pin;
+  _pinReg = portInputRegister(digitalPinToPort(pin));
+  _pinMask = digitalPinToBitMask(pin);
 
   if (activeLow) {
     // the button connects the input pin to GND when pressed.
@@ -135,11 +137,30 @@ void OneButton::reset(void){
 /**
  * @brief Check input of the configured pin and then advance the finite state
  * machine (FSM).
+ * Transitions queued by captureEdge() are fed first with their own
+ * timestamps, then the FSM is advanced to the current time.
  */
 void OneButton::tick(void)
 {
   if (_pin >= 0) {
-    tick(digitalRead(_pin) == _buttonPressed);
+    if (_edgeCaptured) {
+      // take the queue end and the level together, transitions captured
+      // after this point are handled by the next tick().
+      noInterrupts();
+      uint8_t head = _edgeHead;
+      bool level = _edgeLevelNow;
+      interrupts();
+
+      while (_edgeTail != head) {
+        uint8_t tail = _edgeTail;
+        _tick(_edgeLevel[tail], _edgeTime[tail]);
+        _edgeTail = (tail + 1) & (ONEBUTTON_EDGE_QUEUE - 1);
+      } // while
+
+      _tick(level, millis());
+    } else {
+      _tick(digitalRead(_pin) == _buttonPressed, millis());
+    }
   }
 }
 
@@ -149,8 +170,54 @@ void OneButton::tick(void)
  */
 void OneButton::tick(bool activeLevel)
 {
-  unsigned long now = millis(); // current (relative) time in msecs.
+  _tick(activeLevel, millis());
+}
+
+
+/**
+ * @brief Queue the current level of the pin with a timestamp.
+ * Must be called from the pin change interrupt of the pin.
+ */
+bool OneButton::captureEdge(void)
+{
+  if (_pinReg == NULL)
+    return false;
+
+  bool level = (((*_pinReg & _pinMask) ? HIGH : LOW) == _buttonPressed);
+
+  // other pins of the same pin change group trigger the interrupt too.
+  if (_edgeCaptured && (level == _edgeLevelNow))
+    return false;
+
+  uint8_t head = _edgeHead;
+  uint8_t next = (head + 1) & (ONEBUTTON_EDGE_QUEUE - 1);
+
+  if (next == _edgeTail) {
+    // queue is full, tick() continues from the current level.
+    _edgesDropped++;
+  } else {
+    _edgeTime[head] = millis();
+    _edgeLevel[head] = level;
+    _edgeHead = next;
+  } // if
+  _edgeLevelNow = level;
+  _edgeCaptured = true;
+  return true;
+}
+
+
+uint8_t OneButton::getDroppedEdges()
+{
+  return _edgesDropped;
+}
+
 
+/**
+ * @brief Advance the finite state machine (FSM) using the given level at the
+ * given time.
+ */
+void OneButton::_tick(bool activeLevel, unsigned long now)
+{
   // Implementation of the state machine
 
   if (_state == 0) { // waiting for menu pin being pressed.
@@ -167,12 +234,9 @@ void OneButton::tick(bool activeLevel)
       // go back to state 0 without calling a function.
       _state = 0;
 
-    } else if (!activeLevel) {
-      _state = 2; // step to state 2
-      _stopTime = now; // remember stopping time
-
-    } else if ((activeLevel) &&
-               ((unsigned long)(now - _startTime) > _pressTicks)) {
+    } else if ((unsigned long)(now - _startTime) > _pressTicks) {
+      // checked before the release, because a queued release can arrive
+      // after the long press time is already over.
       _isLongPressed = true; // Keep track of long press state
       if (_pressFunc)
         _pressFunc();
@@ -182,6 +246,26 @@ void OneButton::tick(bool activeLevel)
         _duringLongPressFunc();
       _state = 6; // step to state 6
       _stopTime = now; // remember stopping time
+
+      if (!activeLevel) {
+        // released in the same step.
+        _isLongPressed = false;
+        if (_longPressStopFunc)
+          _longPressStopFunc();
+        _state = 0; // restart.
+      } // if
+
+    } else if (!activeLevel) {
+      _state = 2; // step to state 2
+      _stopTime = now; // remember stopping time
+
+      if (_doubleClickFunc == NULL) {
+        // no double click to wait for, this was a single click.
+        if (_clickFunc)
+          _clickFunc();
+        _state = 0; // restart.
+      } // if
+
     } else {
       // wait. Stay in this state.
     } // if
@@ -229,7 +313,7 @@ void OneButton::tick(bool activeLevel)
     } // if
 
   } // if
-} // OneButton.tick()
+} // OneButton._tick()
 
 
 // end.
@@ -18,6 +18,8 @@
 // sources of input.
 // 26.09.2018 Initialization moved into class declaration.
 // 26.09.2018 Jay M Ericsson: compiler warnings removed.
+// 19.10.2026 Timestamped edge queue for pin change interrupts, single click
+// without delay when no double click function is attached.
 // -----
 
 #ifndef OneButton_h
@@ -25,6 +27,12 @@
 
 #include "Arduino.h"
 
+// number of transitions captureEdge() can queue between two tick() calls.
+// must be a power of 2.
+#ifndef ONEBUTTON_EDGE_QUEUE
+#define ONEBUTTON_EDGE_QUEUE 8
+#endif
+
 // ----- Callback function types -----
 
 extern "C" {
@@ -77,12 +85,29 @@ public:
    */
   void tick(bool level);
 
+  /**
+   * @brief Call this function from the pin change interrupt of the pin.
+   * The level is queued with a timestamp and the next tick() feeds the
+   * queued transitions to the FSM in the order they happened, so presses
+   * shorter than one loop() iteration are not lost.
+   * @return true when the level of the button changed, false when another
+   * pin of the interrupt triggered it.
+   */
+  bool captureEdge(void);
+
+  // number of transitions dropped because the edge queue was full.
+  uint8_t getDroppedEdges();
+
   bool isLongPressed();
   int getPressedTicks();
   void reset(void);
 
 private:
+  void _tick(bool activeLevel, unsigned long now);
+
   int _pin; // hardware pin number.
+  volatile uint8_t *_pinReg = NULL; // input register of the pin.
+  uint8_t _pinMask = 0; // bit mask of the pin in _pinReg.
   unsigned int _debounceTicks = 50; // number of ticks for debounce times.
   unsigned int _clickTicks = 600; // number of ticks that have to pass by
                                   // before a click is detected.
@@ -107,6 +132,16 @@ private:
   int _state = 0;
   unsigned long _startTime; // will be set in state 1
   unsigned long _stopTime; // will be set in state 2
+
+  // Transitions captured by captureEdge(), written by the interrupt at
+  // _edgeHead and consumed by tick() at _edgeTail.
+  unsigned long _edgeTime[ONEBUTTON_EDGE_QUEUE];
+  bool _edgeLevel[ONEBUTTON_EDGE_QUEUE];
+  volatile uint8_t _edgeHead = 0;
+  volatile uint8_t _edgeTail = 0;
+  volatile bool _edgeLevelNow = false; // level of the last captured edge.
+  volatile bool _edgeCaptured = false; // captureEdge() is in use.
+  volatile uint8_t _edgesDropped = 0;
 };
 
 #endif
@@ -0,0 +1,48 @@
+// -----
+// DutyCycleModel.h - Expected share of time the controller is awake.
+// Plain integer arithmetic without hardware access, so the model can be
+// compiled and checked on the host and compared with
+// PowerManager::getDutyPermille() on the controller.
+// -----
+// 19.10.2026 created
+// -----
+
+#ifndef DutyCycleModel_h
+#define DutyCycleModel_h
+
+#include <stdint.h>
+
+struct DutyCycleTask {
+  uint16_t periodMillis; // 0 runs the task on every wake up.
+  uint16_t runtimeMicros; // runtime of one run.
+};
+
+/**
+ * @brief Expected awake time in per mille.
+ * @param wakeupsPerSecond timer ticks per second, 122 for the 8.192 ms Timer2
+ * tick, 977 for the Timer0 tick.
+ * @param wakeupMicros cost of one wake up: interrupt, sleep entry and the
+ * scheduler pass checking for due tasks.
+ */
+inline uint16_t expectedDutyPermille(const DutyCycleTask *tasks, uint8_t count,
+                                     uint16_t wakeupsPerSecond, uint16_t wakeupMicros)
+{
+  // awake microseconds per second
+  uint32_t awake = (uint32_t)wakeupsPerSecond * wakeupMicros;
+
+  for (uint8_t i = 0; i < count; i++) {
+    if (tasks[i].periodMillis == 0) {
+      awake += (uint32_t)wakeupsPerSecond * tasks[i].runtimeMicros;
+    } else {
+      awake += (uint32_t)tasks[i].runtimeMicros * 1000 / tasks[i].periodMillis;
+    }
+  }
+
+  // 1 per mille of a second is 1000 us
+  if (awake >= 1000000UL) {
+    return 1000;
+  }
+  return (uint16_t)(awake / 1000);
+}
+
+#endif
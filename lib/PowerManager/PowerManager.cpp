@@ -0,0 +1,232 @@
+// -----
+// PowerManager.cpp - Idle sleep between the tasks of the cooperative scheduler.
+// -----
+// 19.10.2026 created
+// 19.10.2026 deep sleep measured in Timer2 ticks, CSV export of the duty cycle
+// 19.10.2026 millis() advanced by the time within the last Timer2 tick
+// -----
+
+#include "PowerManager.h"
+#include "SleepClockModel.h"
+#include <avr/sleep.h>
+#include <avr/power.h>
+
+// time keeping of the Arduino core (wiring.c), advanced by Timer2 while the
+// Timer0 overflow interrupt is off.
+extern volatile unsigned long timer0_overflow_count;
+extern volatile unsigned long timer0_millis;
+
+// Timer2 runs with prescaler 1024 (64 us) and counts to 128:
+// 8.192 ms, exactly 8 Timer0 overflows of 1.024 ms.
+#define POWER_TICK_COUNT 128
+#define POWER_TICK_OVERFLOWS 8
+#define POWER_TICK_MILLIS 8
+#define POWER_TICK_FRACT 192 // us over POWER_TICK_MILLIS
+#define POWER_TICK_MICROS 8192UL
+#define POWER_COUNT_MICROS 64
+
+static volatile bool timer2Tick = false;
+static volatile uint16_t timer2Fract = 0;
+// Timer2 ticks since the deep sleep was entered.
+static volatile uint16_t timer2Ticks = 0;
+
+ISR(TIMER2_COMPA_vect)
+{
+  timer0_overflow_count += POWER_TICK_OVERFLOWS;
+  timer0_millis += POWER_TICK_MILLIS;
+  timer2Fract += POWER_TICK_FRACT;
+  if (timer2Fract >= 1000) {
+    timer2Fract -= 1000;
+    timer0_millis++;
+  }
+  // the pending Timer0 overflow is counted above, micros() must not add it.
+  TIFR0 = _BV(TOV0);
+  timer2Tick = true;
+  timer2Ticks++;
+}
+
+
+// TCNT0 with interrupts off, never 255: the next overflow is at least one
+// count away, so clearing TOV0 right after cannot lose it.
+static uint8_t readTimer0(void)
+{
+  uint8_t count;
+  while ((count = TCNT0) == 255) {
+  }
+  return count;
+} // readTimer0
+
+
+// ----- Initialization and Default Values -----
+
+PowerManager::PowerManager()
+{
+  _wakeUp = false;
+  _windowStart = 0;
+  _asleepMicros = 0;
+  _dutyPermille = 1000;
+  _timer0Start = 0;
+  _printHeader = true;
+}
+
+
+void PowerManager::begin(void)
+{
+  // Timer2 in CTC mode, interrupt enabled only in deep sleep.
+  TCCR2A = _BV(WGM21);
+  TCCR2B = _BV(CS22) | _BV(CS21) | _BV(CS20);
+  OCR2A = POWER_TICK_COUNT - 1;
+  TIMSK2 = 0;
+
+  // not used by the controller
+  power_spi_disable();
+  power_adc_disable();
+
+  _windowStart = millis();
+} // begin
+
+
+void PowerManager::wakeUp(void)
+{
+  _wakeUp = true;
+}
+
+
+bool PowerManager::takeWakeUp(void)
+{
+  if (!_wakeUp) {
+    return false;
+  }
+  _wakeUp = false;
+  return true;
+}
+
+
+uint16_t PowerManager::getDutyPermille(void)
+{
+  return _dutyPermille;
+}
+
+
+void PowerManager::_enterDeep(void)
+{
+  noInterrupts();
+  TCNT2 = 0;
+  timer2Ticks = 0;
+  TIFR2 = _BV(OCF2A);
+  TIMSK2 = _BV(OCIE2A);
+  TIMSK0 &= ~_BV(TOIE0);
+
+  // an overflow not handled yet is counted here, later ones by _leaveDeep().
+  _timer0Start = readTimer0();
+  if (TIFR0 & _BV(TOV0)) {
+    sleepAdvanceClock(timer0_millis, timer0_overflow_count, timer2Fract, 1);
+    TIFR0 = _BV(TOV0);
+  }
+  interrupts();
+}
+
+
+// returns the time since _enterDeep() from the Timer2 ticks and count.
+// micros() cannot measure it: while the Timer0 interrupt is off, it is
+// advanced by whole Timer2 ticks and may step back within a tick.
+// The Timer0 overflows not counted by the Timer2 interrupt, a pending tick
+// and the time since the last tick, are added to millis() before the Timer0
+// interrupt takes over again. Short sleeps, e.g. in the moisture window,
+// end before the first tick.
+unsigned long PowerManager::_leaveDeep(void)
+{
+  noInterrupts();
+  uint8_t count = TCNT2;
+  unsigned long ticks = timer2Ticks;
+  if (TIFR2 & _BV(OCF2A)) {
+    // the compare match of this tick is not handled anymore.
+    ticks++;
+    count = TCNT2;
+  }
+  TIMSK2 = 0;
+  unsigned long asleep = ticks * POWER_TICK_MICROS + count * POWER_COUNT_MICROS;
+
+  unsigned long overflows = sleepOverflows(asleep, _timer0Start, readTimer0());
+  TIFR0 = _BV(TOV0);
+  unsigned long counted = (unsigned long)timer2Ticks * POWER_TICK_OVERFLOWS;
+  if (overflows > counted) {
+    sleepAdvanceClock(timer0_millis, timer0_overflow_count, timer2Fract, overflows - counted);
+  }
+  TIMSK0 |= _BV(TOIE0);
+  interrupts();
+
+  return asleep;
+}
+
+
+void PowerManager::sleep(unsigned long millisUntilNextTask, bool deep)
+{
+  unsigned long start = micros();
+  unsigned long asleep = 0;
+
+  if (millisUntilNextTask > 0) {
+    // the Timer2 tick is the time resolution in deep sleep.
+    deep = deep && (millisUntilNextTask >= POWER_TICK_MILLIS);
+    unsigned long wakeMillis = millis() + millisUntilNextTask;
+
+    if (deep) {
+      _enterDeep();
+    }
+
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    do {
+      timer2Tick = false;
+
+      noInterrupts();
+      if (!_wakeUp) {
+        sleep_enable();
+        interrupts(); // the next instruction is executed before any interrupt
+        sleep_cpu();
+        sleep_disable();
+      }
+      interrupts();
+
+      // only the Timer2 tick lets the controller sleep on until the task is due.
+    } while (deep && timer2Tick && !_wakeUp && ((long)(millis() - wakeMillis) < 0));
+
+    if (deep) {
+      asleep = _leaveDeep();
+    } else {
+      // Timer0 kept running, micros() is continuous.
+      asleep = micros() - start;
+    }
+  }
+  _asleepMicros += asleep;
+
+  // millis() never steps back, also not in deep sleep.
+  unsigned long now = millis();
+  unsigned long window = now - _windowStart;
+  if (window >= 1000) {
+    // microseconds per millisecond are per mille
+    unsigned long asleepPermille = _asleepMicros / window;
+    _dutyPermille = (asleepPermille >= 1000) ? 0 : 1000 - asleepPermille;
+    _asleepMicros = 0;
+    _windowStart = now;
+  }
+} // sleep
+
+
+bool PowerManager::printCsvLine(Print &out, uint16_t expectedPermille)
+{
+  if (_printHeader) {
+    out.println(F("duty_permille,expected_permille"));
+    _printHeader = false;
+    return false;
+  }
+
+  out.print(_dutyPermille);
+  out.print(',');
+  out.println(expectedPermille);
+
+  _printHeader = true;
+  return true;
+} // printCsvLine
+
+
+// end.
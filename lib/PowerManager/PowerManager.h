@@ -0,0 +1,65 @@
+// -----
+// PowerManager.h - Idle sleep between the tasks of the cooperative scheduler.
+// The controller sleeps in idle mode until the next task is due. In deep
+// sleep the 1 ms Timer0 interrupt is switched off and Timer2 keeps millis()
+// and micros() running with one tick every 8.192 ms, so the controller only
+// wakes for the Timer2 tick or a pin change interrupt of an input. The time
+// within the last tick is added when the controller leaves deep sleep.
+// The Nano has no 32 kHz crystal on TOSC1/TOSC2, so Timer2 runs from the
+// system clock and idle is the deepest mode that keeps it running.
+// -----
+// 19.10.2026 created
+// 19.10.2026 deep sleep measured in Timer2 ticks, CSV export of the duty cycle
+// 19.10.2026 millis() advanced by the time within the last Timer2 tick
+// -----
+
+#ifndef PowerManager_h
+#define PowerManager_h
+
+#include "Arduino.h"
+
+class PowerManager
+{
+public:
+  // ----- Constructor -----
+  PowerManager();
+
+  // sets up the Timer2 tick and switches off unused peripherals.
+  void begin(void);
+
+  /**
+   * @brief Sleep until the next task is due or an input wakes the controller.
+   * @param millisUntilNextTask from CoopScheduler::millisUntilNextTask().
+   * @param deep use the 8 ms Timer2 tick instead of the 1 ms Timer0 tick.
+   */
+  void sleep(unsigned long millisUntilNextTask, bool deep);
+
+  // call from the pin change interrupts of the inputs.
+  void wakeUp(void);
+
+  // true once after an input woke the controller.
+  bool takeWakeUp(void);
+
+  // measured share of time awake in the last second, in per mille.
+  uint16_t getDutyPermille(void);
+
+  /**
+   * @brief Print the next line of the CSV frame, header first, then
+   * duty_permille,expected_permille, e.g. from expectedDutyPermille().
+   * @return true when the frame is complete.
+   */
+  bool printCsvLine(Print &out, uint16_t expectedPermille);
+
+private:
+  void _enterDeep(void);
+  unsigned long _leaveDeep(void);
+
+  volatile bool _wakeUp;
+  uint8_t _timer0Start; // TCNT0 when the deep sleep was entered.
+  unsigned long _windowStart; // millis() when the measurement window started.
+  unsigned long _asleepMicros; // time asleep in the current window.
+  uint16_t _dutyPermille;
+  bool _printHeader;
+};
+
+#endif
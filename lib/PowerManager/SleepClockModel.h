@@ -0,0 +1,44 @@
+// -----
+// SleepClockModel.h - millis() and micros() of the Arduino core across a
+// deep sleep, while the Timer0 overflow interrupt is off.
+// Plain integer arithmetic without hardware access, so it can be compiled
+// and checked on the host.
+// -----
+// 19.10.2026 created
+// -----
+
+#ifndef SleepClockModel_h
+#define SleepClockModel_h
+
+#include <stdint.h>
+
+/**
+ * @brief Timer0 overflows (1.024 ms, 256 counts of 4 us) during a deep sleep.
+ * @param elapsedMicros time from the Timer2 ticks and count, 64 us resolution.
+ * @param timer0Start TCNT0 when the sleep was entered.
+ * @param timer0End TCNT0 when the sleep was left.
+ * Timer0 keeps counting, so the counts give the exact position within an
+ * overflow and the coarse Timer2 time only has to be right to half an overflow.
+ */
+inline unsigned long sleepOverflows(unsigned long elapsedMicros, uint8_t timer0Start, uint8_t timer0End)
+{
+  unsigned long counts = elapsedMicros + 512 + (unsigned long)timer0Start * 4;
+  unsigned long end = (unsigned long)timer0End * 4;
+  return (counts > end) ? (counts - end) / 1024 : 0;
+}
+
+/**
+ * @brief Advance the time keeping of the Arduino core like the Timer0
+ * overflow interrupt does, overflows times.
+ * @param fractMicros microseconds over millis, below 1000.
+ */
+inline void sleepAdvanceClock(volatile unsigned long &millis, volatile unsigned long &overflowCount,
+                              volatile uint16_t &fractMicros, unsigned long overflows)
+{
+  unsigned long micros = fractMicros + overflows * 1024;
+  overflowCount += overflows;
+  millis += micros / 1000;
+  fractMicros = micros % 1000;
+}
+
+#endif
@@ -0,0 +1,139 @@
+// -----
+// PumpDispatcher.cpp - Decides when requested pump runs may start.
+// -----
+// 19.10.2026 created
+// -----
+
+#include "PumpDispatcher.h"
+
+// ----- Initialization and Default Values -----
+
+PumpDispatcher::PumpDispatcher(uint8_t count, uint16_t budget, uint16_t staggerMillis)
+{
+  _count = (count > PUMPDISPATCHER_MAX) ? PUMPDISPATCHER_MAX : count;
+  _budget = budget;
+  _staggerMillis = staggerMillis;
+  _load = 0;
+  _queueLength = 0;
+  _running = 0;
+  _lastStartMillis = 0;
+  _started = false;
+
+  for (uint8_t i = 0; i < PUMPDISPATCHER_MAX; i++) {
+    _weight[i] = 1;
+    _priority[i] = 0;
+  }
+} // PumpDispatcher
+
+
+void PumpDispatcher::setWeight(uint8_t channel, uint16_t weight)
+{
+  if ((channel >= _count) || isRunning(channel))
+    return;
+
+  _weight[channel] = weight;
+} // setWeight
+
+
+void PumpDispatcher::setPriority(uint8_t channel, uint8_t priority)
+{
+  if (channel >= _count)
+    return;
+
+  _priority[channel] = priority;
+} // setPriority
+
+
+void PumpDispatcher::request(uint8_t channel)
+{
+  if ((channel >= _count) || isQueued(channel) || isRunning(channel))
+    return;
+
+  _queue[_queueLength++] = channel;
+} // request
+
+
+void PumpDispatcher::release(uint8_t channel)
+{
+  if (isRunning(channel)) {
+    _running &= ~_BV(channel);
+    _load -= _weight[channel];
+    return;
+  }
+
+  for (uint8_t p = 0; p < _queueLength; p++) {
+    if (_queue[p] == channel) {
+      _remove(p);
+      return;
+    }
+  }
+} // release
+
+
+uint8_t PumpDispatcher::next(unsigned long now)
+{
+  if (_queueLength == 0)
+    return PUMPDISPATCHER_NONE;
+
+  if (_started && (now - _lastStartMillis < _staggerMillis))
+    return PUMPDISPATCHER_NONE;
+
+  // highest priority, the first to arrive wins a tie
+  uint8_t best = 0;
+  for (uint8_t p = 1; p < _queueLength; p++) {
+    if (_priority[_queue[p]] > _priority[_queue[best]]) {
+      best = p;
+    }
+  }
+
+  uint8_t channel = _queue[best];
+  if ((_load > 0) && (_load + _weight[channel] > _budget))
+    return PUMPDISPATCHER_NONE;
+
+  _remove(best);
+  _running |= _BV(channel);
+  _load += _weight[channel];
+  _lastStartMillis = now;
+  _started = true;
+  return channel;
+} // next
+
+
+bool PumpDispatcher::isQueued(uint8_t channel)
+{
+  for (uint8_t p = 0; p < _queueLength; p++) {
+    if (_queue[p] == channel)
+      return true;
+  }
+  return false;
+} // isQueued
+
+
+bool PumpDispatcher::isRunning(uint8_t channel)
+{
+  return (channel < _count) && (_running & _BV(channel));
+}
+
+
+uint8_t PumpDispatcher::getQueueLength(void)
+{
+  return _queueLength;
+}
+
+
+uint16_t PumpDispatcher::getLoad(void)
+{
+  return _load;
+}
+
+
+void PumpDispatcher::_remove(uint8_t position)
+{
+  for (uint8_t p = position + 1; p < _queueLength; p++) {
+    _queue[p - 1] = _queue[p];
+  }
+  _queueLength--;
+} // _remove
+
+
+// end.
@@ -0,0 +1,73 @@
+// -----
+// PumpDispatcher.h - Decides when requested pump runs may start, so the
+// running pumps stay within the capacity of the power supply.
+// Every pump has a weight (its current in any unit) and the running pumps
+// may not exceed the budget. With all weights 1 the budget is the number of
+// pumps running at the same time. Two starts are at least staggerMillis apart,
+// so the inrush currents do not add up.
+// Requests are queued by priority, then in order of arrival. A request that
+// does not fit blocks the ones behind it, so a heavy pump is never starved.
+// A queued run is only delayed, it keeps its full length.
+// -----
+// 19.10.2026 created
+// -----
+
+#ifndef PumpDispatcher_h
+#define PumpDispatcher_h
+
+#include "Arduino.h"
+
+#define PUMPDISPATCHER_MAX 8
+#define PUMPDISPATCHER_NONE 0xFF
+
+class PumpDispatcher
+{
+public:
+  // ----- Constructor -----
+  // all pumps have weight 1 and priority 0.
+  PumpDispatcher(uint8_t count, uint16_t budget, uint16_t staggerMillis);
+
+  // a pump heavier than the budget runs when nothing else runs.
+  void setWeight(uint8_t channel, uint16_t weight);
+
+  // higher priority starts first.
+  void setPriority(uint8_t channel, uint8_t priority);
+
+  // queues a run, ignored when the pump is queued or running.
+  void request(uint8_t channel);
+
+  // removes the pump from the queue, or frees its share of the budget.
+  void release(uint8_t channel);
+
+  // returns the pump that starts now and marks it running,
+  // PUMPDISPATCHER_NONE when no start is allowed. Call it until it returns NONE.
+  uint8_t next(unsigned long now);
+
+  bool isQueued(uint8_t channel);
+  bool isRunning(uint8_t channel);
+
+  uint8_t getQueueLength(void);
+
+  // sum of the weights of the running pumps.
+  uint16_t getLoad(void);
+
+private:
+  void _remove(uint8_t position);
+
+  uint8_t _count;
+  uint16_t _budget;
+  uint16_t _staggerMillis;
+  uint16_t _load;
+
+  uint16_t _weight[PUMPDISPATCHER_MAX];
+  uint8_t _priority[PUMPDISPATCHER_MAX];
+
+  uint8_t _queue[PUMPDISPATCHER_MAX]; // channels in order of arrival
+  uint8_t _queueLength;
+  uint8_t _running; // bit n is set while pump n runs
+
+  unsigned long _lastStartMillis;
+  bool _started; // _lastStartMillis is valid
+};
+
+#endif
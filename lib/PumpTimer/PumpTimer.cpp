@@ -0,0 +1,121 @@
+// -----
+// PumpTimer.cpp - Run lengths of the pumps counted by Timer1 in milliseconds.
+// -----
+// 19.10.2026 created
+// -----
+
+#include "PumpTimer.h"
+#include <util/atomic.h>
+
+// Timer1 in CTC mode with prescaler 64 (4 us) counts to 250: exactly 1 ms.
+#define PUMPTIMER_TICK_COUNT 250
+
+static PumpTimer *pumpTimer = NULL;
+
+ISR(TIMER1_COMPA_vect)
+{
+  if (pumpTimer) {
+    pumpTimer->tick();
+  }
+}
+
+
+// ----- Initialization and Default Values -----
+
+PumpTimer::PumpTimer(pumpStopFunction stopFunction)
+{
+  _stopFunction = stopFunction;
+  for (uint8_t i = 0; i < PUMPTIMER_CHANNELS; i++) {
+    _remaining[i] = 0;
+    _expired[i] = false;
+  }
+} // PumpTimer
+
+
+void PumpTimer::begin(void)
+{
+  pumpTimer = this;
+
+  TIMSK1 = 0;
+  TCCR1A = 0;
+  TCCR1B = _BV(WGM12) | _BV(CS11) | _BV(CS10);
+  OCR1A = PUMPTIMER_TICK_COUNT - 1;
+  TCNT1 = 0;
+} // begin
+
+
+void PumpTimer::arm(uint8_t channel, unsigned long runMillis)
+{
+  if (channel >= PUMPTIMER_CHANNELS)
+    return;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    _remaining[channel] = (runMillis == 0) ? 1 : runMillis;
+    _expired[channel] = false;
+    TIFR1 = _BV(OCF1A);
+    TIMSK1 = _BV(OCIE1A);
+  }
+} // arm
+
+
+void PumpTimer::cancel(uint8_t channel)
+{
+  if (channel >= PUMPTIMER_CHANNELS)
+    return;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    _remaining[channel] = 0;
+    _expired[channel] = false;
+  }
+} // cancel
+
+
+bool PumpTimer::takeExpired(uint8_t channel)
+{
+  bool expired = false;
+
+  if (channel >= PUMPTIMER_CHANNELS)
+    return false;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    expired = _expired[channel];
+    _expired[channel] = false;
+  }
+  return expired;
+} // takeExpired
+
+
+unsigned long PumpTimer::getRemainingMillis(uint8_t channel)
+{
+  unsigned long remaining;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    remaining = _remaining[channel];
+  }
+  return remaining;
+} // getRemainingMillis
+
+
+void PumpTimer::tick(void)
+{
+  bool armed = false;
+
+  for (uint8_t i = 0; i < PUMPTIMER_CHANNELS; i++) {
+    if (_remaining[i] == 0)
+      continue;
+
+    if (--_remaining[i] == 0) {
+      _stopFunction(i);
+      _expired[i] = true;
+    } else {
+      armed = true;
+    }
+  } // for
+
+  if (!armed) {
+    TIMSK1 = 0; // no interrupts while no pump runs
+  }
+} // tick
+
+
+// end.
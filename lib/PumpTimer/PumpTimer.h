@@ -0,0 +1,54 @@
+// -----
+// PumpTimer.h - Run lengths of the pumps counted by Timer1 in milliseconds.
+// The run is armed when the relay is switched on, and the stop function is
+// called from the Timer1 compare interrupt, so the run length does not
+// depend on how long the rest of the loop takes.
+// -----
+// 19.10.2026 created
+// -----
+
+#ifndef PumpTimer_h
+#define PumpTimer_h
+
+#include "Arduino.h"
+
+#define PUMPTIMER_CHANNELS 2
+
+extern "C" {
+// switches the relay of the channel off, called from the interrupt.
+typedef void (*pumpStopFunction)(uint8_t channel);
+}
+
+class PumpTimer
+{
+public:
+  // ----- Constructor -----
+  PumpTimer(pumpStopFunction stopFunction);
+
+  // sets up Timer1 for a 1 ms compare interrupt, enabled only while a run is armed.
+  void begin(void);
+
+  /**
+   * @brief Stop the channel after runMillis, call right after switching the relay on.
+   * The first millisecond may be up to 1 ms short, up to 49 days are possible.
+   */
+  void arm(uint8_t channel, unsigned long runMillis);
+
+  // forget the run, e.g. when the pump is stopped by hand.
+  void cancel(uint8_t channel);
+
+  // true once after the run of the channel ended and the stop function was called.
+  bool takeExpired(uint8_t channel);
+
+  unsigned long getRemainingMillis(uint8_t channel);
+
+  // called by the Timer1 compare interrupt every millisecond.
+  void tick(void);
+
+private:
+  pumpStopFunction _stopFunction;
+  volatile unsigned long _remaining[PUMPTIMER_CHANNELS]; // 0 when not armed
+  volatile bool _expired[PUMPTIMER_CHANNELS];
+};
+
+#endif
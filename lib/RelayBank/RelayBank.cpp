@@ -0,0 +1,174 @@
+// -----
+// RelayBank.cpp - Relay outputs kept as a bitmask and written by an output
+// backend.
+// -----
+// 19.10.2026 created
+// 19.10.2026 output backends, up to 32 relays.
+// -----
+
+#include "RelayBank.h"
+#include <util/atomic.h>
+
+static volatile uint8_t *portRegister(uint8_t port)
+{
+  switch (port) {
+  case RELAYBANK_PORTB:
+    return &PORTB;
+  case RELAYBANK_PORTC:
+    return &PORTC;
+  default:
+    return &PORTD;
+  }
+} // portRegister
+
+
+static volatile uint8_t *ddrRegister(uint8_t port)
+{
+  switch (port) {
+  case RELAYBANK_PORTB:
+    return &DDRB;
+  case RELAYBANK_PORTC:
+    return &DDRC;
+  default:
+    return &DDRD;
+  }
+} // ddrRegister
+
+
+// ----- RelayPortOutput -----
+
+RelayPortOutput::RelayPortOutput(const RelayChannel *channels, uint8_t count)
+{
+  _channels = channels;
+  _count = (count > RELAYBANK_MAX) ? RELAYBANK_MAX : count;
+
+  for (uint8_t p = 0; p < RELAYBANK_PORTS; p++) {
+    _portMask[p] = 0;
+  }
+  for (uint8_t i = 0; i < _count; i++) {
+    _portMask[_channels[i].port] |= _channels[i].mask;
+  }
+
+  // off level first, so a relay never pulses on when the pin becomes an output
+  write(0, 0);
+  for (uint8_t p = 0; p < RELAYBANK_PORTS; p++) {
+    if (_portMask[p]) {
+      *ddrRegister(p) |= _portMask[p];
+    }
+  }
+} // RelayPortOutput
+
+
+// one read-modify-write per port, interrupts must be off.
+bool RelayPortOutput::write(uint32_t state, uint32_t changed)
+{
+  uint8_t level[RELAYBANK_PORTS] = {0, 0, 0};
+
+  for (uint8_t i = 0; i < _count; i++) {
+    const RelayChannel &c = _channels[i];
+    bool on = state & ((uint32_t)1 << i);
+    if (on != c.activeLow) {
+      level[c.port] |= c.mask;
+    }
+  }
+
+  for (uint8_t p = 0; p < RELAYBANK_PORTS; p++) {
+    if (!_portMask[p])
+      continue;
+
+    volatile uint8_t *reg = portRegister(p);
+    *reg = (*reg & ~_portMask[p]) | level[p];
+  }
+  return true;
+} // write
+
+
+// ----- RelayBank -----
+
+RelayBank::RelayBank(RelayOutput &output, uint8_t count) : _output(output)
+{
+  _count = (count > RELAYBANK_MAX) ? RELAYBANK_MAX : count;
+  _state = 0;
+  _applied = 0;
+} // RelayBank
+
+
+void RelayBank::begin(void)
+{
+  _output.begin();
+
+  // everything is written once, whatever the output did before
+  _applied = ~getState();
+  apply();
+} // begin
+
+
+void RelayBank::set(uint8_t channel, bool on)
+{
+  if (channel >= _count)
+    return;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (on) {
+      _state |= (uint32_t)1 << channel;
+    } else {
+      _state &= ~((uint32_t)1 << channel);
+    }
+  }
+} // set
+
+
+bool RelayBank::get(uint8_t channel)
+{
+  return getState() & ((uint32_t)1 << channel);
+}
+
+
+uint32_t RelayBank::getState(void)
+{
+  uint32_t state;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    state = _state;
+  }
+  return state;
+}
+
+
+void RelayBank::apply(void)
+{
+  if (_output.isInterruptSafe()) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      _apply();
+    }
+  } else {
+    // a slow output runs with interrupts on, a change in between
+    // is written by the next apply()
+    _apply();
+  }
+} // apply
+
+
+bool RelayBank::applyFromInterrupt(void)
+{
+  if (!_output.isInterruptSafe())
+    return false;
+
+  _apply();
+  return true;
+} // applyFromInterrupt
+
+
+// one write of the output for all changed relays.
+void RelayBank::_apply(void)
+{
+  uint32_t state = getState();
+  if (state == _applied)
+    return;
+
+  if (_output.write(state, state ^ _applied)) {
+    _applied = state;
+  }
+} // _apply
+
+
+// end.
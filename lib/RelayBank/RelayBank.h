@@ -0,0 +1,101 @@
+// -----
+// RelayBank.h - Relay outputs kept as a bitmask. The bitmask is written by
+// an output backend, in one batch and only when it changed:
+// - RelayPortOutput: pins of the controller, one read-modify-write per port.
+// - RelayShiftOutput: a chain of 74HC595, see RelayShiftOutput.h.
+// - RelayExpanderOutput: PCF8574 on the I2C bus, see RelayExpanderOutput.h.
+// Pins of RelayPortOutput are resolved to port and bit mask at compile time,
+// for the pin numbering of the ATmega328P (Uno, Nano).
+// -----
+// 19.10.2026 created
+// 19.10.2026 output backends, up to 32 relays.
+// -----
+
+#ifndef RelayBank_h
+#define RelayBank_h
+
+#include "Arduino.h"
+
+#define RELAYBANK_MAX 32
+
+#define RELAYBANK_PORTB 0
+#define RELAYBANK_PORTC 1
+#define RELAYBANK_PORTD 2
+#define RELAYBANK_PORTS 3
+
+// D0-D7 are on port D, D8-D13 on port B and A0-A5 on port C.
+#define RELAYBANK_PORT_OF(pin) ((pin) < 8 ? RELAYBANK_PORTD : ((pin) < 14 ? RELAYBANK_PORTB : RELAYBANK_PORTC))
+#define RELAYBANK_MASK_OF(pin) (1 << ((pin) < 8 ? (pin) : ((pin) < 14 ? (pin) - 8 : (pin) - 14)))
+
+// entry of the channel table: RELAYBANK_CHANNEL(RELAY1, true)
+#define RELAYBANK_CHANNEL(pin, activeLow) { RELAYBANK_PORT_OF(pin), RELAYBANK_MASK_OF(pin), activeLow }
+
+struct RelayChannel {
+  uint8_t port;
+  uint8_t mask;
+  bool activeLow; // relay is on when the pin is LOW
+};
+
+// Writes the relay states to the hardware. Bit n of state is set when relay n
+// should be on, changed has the bits that differ from the last write.
+class RelayOutput
+{
+public:
+  // called once from setup(), before the first write.
+  virtual void begin(void) {}
+
+  // returns false when the state did not reach the relays, it is written again.
+  virtual bool write(uint32_t state, uint32_t changed) = 0;
+
+  // write() is short and may be called from an interrupt.
+  virtual bool isInterruptSafe(void) { return true; }
+};
+
+// relays on pins of the controller, switched off in the constructor.
+class RelayPortOutput : public RelayOutput
+{
+public:
+  RelayPortOutput(const RelayChannel *channels, uint8_t count);
+
+  bool write(uint32_t state, uint32_t changed);
+
+private:
+  const RelayChannel *_channels;
+  uint8_t _count;
+  uint8_t _portMask[RELAYBANK_PORTS]; // bits owned by the output
+};
+
+class RelayBank
+{
+public:
+  // ----- Constructor -----
+  RelayBank(RelayOutput &output, uint8_t count);
+
+  // starts the output and writes all relays off.
+  // RelayPortOutput and RelayShiftOutput are off from their constructors already.
+  void begin(void);
+
+  // changes the wanted state only, see apply().
+  void set(uint8_t channel, bool on);
+  bool get(uint8_t channel);
+
+  // bit n is set when relay n should be on.
+  uint32_t getState(void);
+
+  // writes the wanted state to the output, if it changed.
+  void apply(void);
+
+  // apply() for an interrupt. Returns false when the output is not
+  // interrupt safe, the state is then written by the next apply().
+  bool applyFromInterrupt(void);
+
+private:
+  void _apply(void);
+
+  RelayOutput &_output;
+  uint8_t _count;
+  volatile uint32_t _state;
+  uint32_t _applied;
+};
+
+#endif
@@ -0,0 +1,45 @@
+// -----
+// RelayExpanderOutput.cpp - Relay output through PCF8574 I/O expanders.
+// -----
+// 19.10.2026 created
+// -----
+
+#include "RelayExpanderOutput.h"
+#include <TwiMaster.h>
+
+RelayExpanderOutput::RelayExpanderOutput(uint8_t address, uint8_t chips, bool activeLow)
+{
+  _address = address;
+  _chips = (chips * 8 > RELAYBANK_MAX) ? RELAYBANK_MAX / 8 : chips;
+  _invert = activeLow ? 0xFFFFFFFF : 0;
+} // RelayExpanderOutput
+
+
+void RelayExpanderOutput::begin(void)
+{
+  Twi.begin();
+} // begin
+
+
+// one single byte transaction per expander with a changed relay.
+// a failed expander makes the whole write fail, RelayBank writes it again.
+bool RelayExpanderOutput::write(uint32_t state, uint32_t changed)
+{
+  uint32_t level = state ^ _invert;
+  bool ok = true;
+
+  for (uint8_t chip = 0; chip < _chips; chip++) {
+    uint8_t shift = chip * 8;
+    if (!((changed >> shift) & 0xFF))
+      continue;
+
+    uint8_t data = level >> shift;
+    if (Twi.write(_address + chip, &data, 1) != TwiMaster::OK) {
+      ok = false;
+    }
+  }
+  return ok;
+} // write
+
+
+// end.
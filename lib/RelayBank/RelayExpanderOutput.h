@@ -0,0 +1,33 @@
+// -----
+// RelayExpanderOutput.h - Relay output through PCF8574 I/O expanders on the
+// I2C bus of the LCD. Relay n is pin Pn%8 of the expander at address + n/8,
+// only expanders with a changed relay get a transaction.
+// The bus is shared with the LCD, so write() must not run in an interrupt.
+// -----
+// 19.10.2026 created
+// -----
+
+#ifndef RelayExpanderOutput_h
+#define RelayExpanderOutput_h
+
+#include "RelayBank.h"
+
+class RelayExpanderOutput : public RelayOutput
+{
+public:
+  RelayExpanderOutput(uint8_t address, uint8_t chips, bool activeLow);
+
+  // starts the I2C bus, the expanders are written by RelayBank::begin().
+  // PCF8574 pins are high after power-up, active-low relays stay off.
+  void begin(void);
+
+  bool write(uint32_t state, uint32_t changed);
+  bool isInterruptSafe(void) { return false; }
+
+private:
+  uint8_t _address;
+  uint8_t _chips;
+  uint32_t _invert;
+};
+
+#endif
@@ -0,0 +1,56 @@
+// -----
+// RelayShiftOutput.cpp - Relay output through a chain of 74HC595.
+// -----
+// 19.10.2026 created
+// -----
+
+#include "RelayShiftOutput.h"
+
+RelayShiftOutput::RelayShiftOutput(uint8_t dataPin, uint8_t clockPin, uint8_t latchPin, uint8_t chips, bool activeLow)
+{
+  // The pins are resolved to their output register and bit mask once,
+  // so write() does not need digitalWrite().
+  _dataReg = portOutputRegister(digitalPinToPort(dataPin));
+  _clockReg = portOutputRegister(digitalPinToPort(clockPin));
+  _latchReg = portOutputRegister(digitalPinToPort(latchPin));
+  _dataMask = digitalPinToBitMask(dataPin);
+  _clockMask = digitalPinToBitMask(clockPin);
+  _latchMask = digitalPinToBitMask(latchPin);
+
+  _bits = (chips * 8 > RELAYBANK_MAX) ? RELAYBANK_MAX : chips * 8;
+  _invert = activeLow ? 0xFFFFFFFF : 0;
+
+  pinMode(dataPin, OUTPUT);
+  pinMode(clockPin, OUTPUT);
+  pinMode(latchPin, OUTPUT);
+  write(0, 0);
+} // RelayShiftOutput
+
+
+// the last relay is shifted first, it ends up in the last chip.
+// about 1 us per bit, safe for an interrupt.
+bool RelayShiftOutput::write(uint32_t state, uint32_t changed)
+{
+  uint32_t level = state ^ _invert;
+
+  uint8_t oldSREG = SREG;
+  cli();
+  for (uint8_t i = _bits; i > 0; i--) {
+    if (level & ((uint32_t)1 << (i - 1))) {
+      *_dataReg |= _dataMask;
+    } else {
+      *_dataReg &= ~_dataMask;
+    }
+    *_clockReg |= _clockMask;
+    *_clockReg &= ~_clockMask;
+  }
+  // the storage register takes all outputs at once
+  *_latchReg |= _latchMask;
+  *_latchReg &= ~_latchMask;
+  SREG = oldSREG;
+
+  return true;
+} // write
+
+
+// end.
@@ -0,0 +1,33 @@
+// -----
+// RelayShiftOutput.h - Relay output through a chain of 74HC595 shift
+// registers, bit-banged on three pins. Every write shifts the whole chain and
+// latches it once, so all relays switch together and the cost depends on the
+// length of the chain only. Relay n is output Qn%8 of chip n/8, chip 0 is the
+// one connected to the data pin.
+// Tie /OE high with a pull-up and low from the controller, or the outputs are
+// undefined until the constructor has run.
+// -----
+// 19.10.2026 created
+// -----
+
+#ifndef RelayShiftOutput_h
+#define RelayShiftOutput_h
+
+#include "RelayBank.h"
+
+class RelayShiftOutput : public RelayOutput
+{
+public:
+  // the relays are switched off right away.
+  RelayShiftOutput(uint8_t dataPin, uint8_t clockPin, uint8_t latchPin, uint8_t chips, bool activeLow);
+
+  bool write(uint32_t state, uint32_t changed);
+
+private:
+  volatile uint8_t *_dataReg, *_clockReg, *_latchReg; // output registers of the pins.
+  uint8_t _dataMask, _clockMask, _latchMask;           // bit masks of the pins.
+  uint8_t _bits;
+  uint32_t _invert;
+};
+
+#endif
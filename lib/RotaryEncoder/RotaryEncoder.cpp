@@ -7,6 +7,8 @@
 // -----
 // 18.01.2014 created by Matthias Hertel
 // 17.06.2015 minor updates.
+// 19.10.2026 single port read, latch modes and invalid transition counter.
+// 19.10.2026 begin() samples the resting state once the pull-ups settled.
 // -----
 
 #include "Arduino.h"
@@ -16,12 +18,15 @@
 // The array holds the values �1 for the entries where a position was decremented,
 // a 1 for the entries where the position was incremented
 // and 0 in all the other (no change or not valid) cases.
+// Transitions where both signals changed at once are marked with KNOBINVALID.
+
+#define KNOBINVALID 2
 
 const int8_t KNOBDIR[] = {
-  0, -1,  1,  0,
-  1,  0,  0, -1,
-  -1,  0,  0,  1,
-0,  1, -1,  0  };
+  0, -1,  1,  KNOBINVALID,
+  1,  0,  KNOBINVALID, -1,
+  -1,  KNOBINVALID,  0,  1,
+KNOBINVALID,  1, -1,  0  };
 
 
 // positions: [3] 1 0 2 [3] 1 0 2 [3]
@@ -32,27 +37,41 @@ const int8_t KNOBDIR[] = {
 
 // ----- Initialization and Default Values -----
 
-RotaryEncoder::RotaryEncoder(int pin1, int pin2) {
-  
-  // Remember Hardware Setup
-  _pin1 = pin1;
-  _pin2 = pin2;
-  
+RotaryEncoder::RotaryEncoder(int pin1, int pin2, LatchMode mode) {
+
+  // Remember Hardware Setup.
+  // The pins are resolved to their input register and bit mask once,
+  // so tick() does not need digitalRead().
+  _pinReg1 = portInputRegister(digitalPinToPort(pin1));
+  _pinReg2 = portInputRegister(digitalPinToPort(pin2));
+  _mask1 = digitalPinToBitMask(pin1);
+  _mask2 = digitalPinToBitMask(pin2);
+  _mode = mode;
+
   // Setup the input pins and turn on pullup resistor
   pinMode(pin1, INPUT_PULLUP);
   pinMode(pin2, INPUT_PULLUP);
 
-  // when not started in motion, the current state of the encoder should be 3
-  _oldState = 3;
+  // start from the state the encoder is resting in,
+  // so a detent at state 0 does not count as an invalid first transition.
+  _oldState = _readState();
 
   // start with position 0;
   _position = 0;
   _positionExt = 0;
   _positionExtPrev = 0;
+  _invalidTransitions = 0;
 } // RotaryEncoder()
 
 
-long  RotaryEncoder::getPosition() {
+void RotaryEncoder::begin(void) {
+  // right after enabling the pull-ups the inputs may still read low,
+  // the first tick() would then count the rise as a step.
+  _oldState = _readState();
+} // begin()
+
+
+RotaryEncoder::position_t RotaryEncoder::getPosition() {
   return _positionExt;
 } // getPosition()
 
@@ -60,7 +79,7 @@ long  RotaryEncoder::getPosition() {
 RotaryEncoder::Direction RotaryEncoder::getDirection() {
 
     RotaryEncoder::Direction ret = Direction::NOROTATION;
-    
+
     if( _positionExtPrev > _positionExt )
     {
         ret = Direction::COUNTERCLOCKWISE;
@@ -71,47 +90,113 @@ RotaryEncoder::Direction RotaryEncoder::getDirection() {
         ret = Direction::CLOCKWISE;
         _positionExtPrev = _positionExt;
     }
-    else 
+    else
     {
         ret = Direction::NOROTATION;
         _positionExtPrev = _positionExt;
-    }        
-    
+    }
+
     return ret;
 }
 
 
 
-void RotaryEncoder::setPosition(long newPosition) {
+void RotaryEncoder::setPosition(position_t newPosition) {
   // only adjust the external part of the position.
-  _position = ((newPosition<<2) | (_position & 0x03L));
+  switch (_mode) {
+  case LatchMode::FOUR3:
+  case LatchMode::FOUR0:
+    _position = ((newPosition<<2) | (_position & 0x03));
+    break;
+
+  case LatchMode::TWO03:
+    _position = ((newPosition<<1) | (_position & 0x01));
+    break;
+
+  case LatchMode::ONE:
+    _position = newPosition;
+    break;
+  } // switch
   _positionExt = newPosition;
   _positionExtPrev = newPosition;
 } // setPosition()
 
 
+// Both signals are taken from one read of the input register when the pins
+// share a port, so an edge can never fall between the two samples.
+inline uint8_t RotaryEncoder::_readState()
+{
+  uint8_t port1 = *_pinReg1;
+  uint8_t port2 = (_pinReg2 == _pinReg1) ? port1 : *_pinReg2;
+
+  return ((port1 & _mask1) ? 1 : 0) | ((port2 & _mask2) ? 2 : 0);
+} // _readState()
+
+
 void RotaryEncoder::tick(void)
 {
-  int sig1 = digitalRead(_pin1);
-  int sig2 = digitalRead(_pin2);
-  int8_t thisState = sig1 | (sig2 << 1);
+  uint8_t thisState = _readState();
 
   if (_oldState != thisState) {
-    _position += KNOBDIR[thisState | (_oldState<<2)];
-    
-    if (thisState == LATCHSTATE) {
-      _positionExt = _position >> 2;
+    int8_t dir = KNOBDIR[thisState | (_oldState<<2)];
+    _oldState = thisState;
+
+    if (dir == KNOBINVALID) {
+      // a state was skipped, the direction is unknown.
+      _invalidTransitions++;
+      return;
+    }
+
+    _position += dir;
+
+    bool latched = false;
+    position_t newPositionExt = _positionExt;
+
+    switch (_mode) {
+    case LatchMode::FOUR3:
+      if (thisState == LATCHSTATE) {
+        newPositionExt = _position >> 2;
+        latched = true;
+      }
+      break;
+
+    case LatchMode::FOUR0:
+      if (thisState == 0) {
+        newPositionExt = _position >> 2;
+        latched = true;
+      }
+      break;
+
+    case LatchMode::TWO03:
+      if ((thisState == 0) || (thisState == 3)) {
+        newPositionExt = _position >> 1;
+        latched = true;
+      }
+      break;
+
+    case LatchMode::ONE:
+      newPositionExt = _position;
+      latched = true;
+      break;
+    } // switch
+
+    if (latched) {
+      _positionExt = newPositionExt;
       _positionExtTimePrev = _positionExtTime;
       _positionExtTime = millis();
     }
-    
-    _oldState = thisState;
   } // if
 } // tick()
 
 unsigned long RotaryEncoder::getMillisBetweenRotations() const
 {
-  return _positionExtTime - _positionExtTimePrev; 
+  return _positionExtTime - _positionExtTimePrev;
+}
+
+
+uint16_t RotaryEncoder::getInvalidTransitions() const
+{
+  return _invalidTransitions;
 }
 
 
@@ -7,6 +7,9 @@
 // -----
 // 18.01.2014 created by Matthias Hertel
 // 16.06.2019 pin initialization using INPUT_PULLUP
+// 19.10.2026 single port read, selectable latch modes, invalid transition counter
+//            and 16 bit position type.
+// 19.10.2026 begin() samples the resting state once the pull-ups settled.
 // -----
 
 #ifndef RotaryEncoder_h
@@ -21,32 +24,59 @@ class RotaryEncoder
 public:
   enum class Direction { NOROTATION = 0, CLOCKWISE = 1, COUNTERCLOCKWISE = -1};
 
+  // Positions where the encoder reports a new external position.
+  // Encoders with a different detent layout need a different mode.
+  enum class LatchMode {
+    FOUR3 = 1, // full-step: 4 steps per detent, latch at state 3 (default)
+    FOUR0 = 2, // full-step: 4 steps per detent, latch at state 0
+    TWO03 = 3, // half-step: 2 steps per detent, latch at state 0 and 3
+    ONE   = 4  // quarter-step: every valid transition is reported
+  };
+
+  // Position type. 16 bit keeps the update in tick() cheap on 8 bit controllers.
+  typedef int16_t position_t;
+
   // ----- Constructor -----
-  RotaryEncoder(int pin1, int pin2);
-  
+  RotaryEncoder(int pin1, int pin2, LatchMode mode = LatchMode::FOUR3);
+
+  // takes the resting state of the pins again, call before enabling the pin change interrupts.
+  // The pull-ups are enabled by the constructor, so the inputs have settled by setup().
+  void begin(void);
+
   // retrieve the current position
-  long  getPosition();
-  
+  position_t getPosition();
+
   // simple retrieve of the direction the knob was rotated at. 0 = No rotation, 1 = Clockwise, -1 = Counter Clockwise
   Direction getDirection();
 
   // adjust the current position
-  void setPosition(long newPosition);
+  void setPosition(position_t newPosition);
 
   // call this function every some milliseconds or by using an interrupt for handling state changes of the rotary encoder.
   void tick(void);
 
-  // Returns the time in milliseconds between the current observed 
+  // Returns the time in milliseconds between the current observed
   unsigned long getMillisBetweenRotations() const;
 
+  // Returns the number of rejected transitions (both signals changed at once).
+  uint16_t getInvalidTransitions() const;
+
 private:
-  int _pin1, _pin2; // Arduino pins used for the encoder. 
-  
-  volatile int8_t _oldState;
-  
-  volatile long _position;         // Internal position (4 times _positionExt)
-  volatile long _positionExt;      // External position
-  volatile long _positionExtPrev;  // External position (used only for direction checking)
+  uint8_t _readState();
+
+  volatile uint8_t *_pinReg1; // input registers of the encoder pins.
+  volatile uint8_t *_pinReg2; // same as _pinReg1 when both pins share a port.
+  uint8_t _mask1, _mask2;     // bit masks of the encoder pins.
+
+  LatchMode _mode;
+
+  volatile uint8_t _oldState;
+
+  volatile position_t _position;         // Internal position (4 times _positionExt in full-step mode)
+  volatile position_t _positionExt;      // External position
+  volatile position_t _positionExtPrev;  // External position (used only for direction checking)
+
+  volatile uint16_t _invalidTransitions; // Number of rejected transitions.
 
   unsigned long _positionExtTime;     // The time the last position change was detected.
   unsigned long _positionExtTimePrev; // The time the previous position change was detected.
@@ -54,4 +84,4 @@ private:
 
 #endif
 
-// End
\ No newline at end of file
+// End
@@ -0,0 +1,210 @@
+// -----
+// SunTimes.cpp - Sunrise and sunset of a day at a fixed place, integer only.
+// -----
+// 19.10.2026 created
+// 19.10.2026 7th order sine
+// -----
+
+#include "SunTimes.h"
+
+// Q15 is 32768 for 1, binary angles are 65536 for a full turn.
+
+// sin(pi/2 * z) = z * (a1 - z^2 * (a3 - z^2 * (a5 - z^2 * a7))) on -1 <= z <= 1, Q15
+// minimax coefficients of the 7th order, error below 1e-6 before the rounding to Q15.
+#define SIN_A1 51472
+#define SIN_A3 21166
+#define SIN_A5 2605
+#define SIN_A7 143
+
+// acos(x) = sqrt(1 - x) * (a0 - a1 x + a2 x^2 - a3 x^3) on 0 <= x <= 1, Q15
+// (Abramowitz and Stegun 4.4.45, error below 7e-5 rad)
+#define ACOS_A0 51471
+#define ACOS_A1 6951
+#define ACOS_A2 2433
+#define ACOS_A3 614
+#define PI_Q15 102944
+
+// radians to binary angle, 65536 / 2pi
+#define RAD_TO_ANGLE 10430
+
+// cos(90.833 degree), the upper limb of the sun with refraction
+#define COS_ZENITH -476
+
+// minutes of time per radian of hour angle, 4 * 180 / pi, Q4
+#define MINUTES_PER_RAD_Q4 3667
+
+// declination in radians, Q15 coefficients of the NOAA series
+// 0.006918 - 0.399912 cos g + 0.070257 sin g - 0.006758 cos 2g
+//   + 0.000907 sin 2g - 0.002697 cos 3g + 0.00148 sin 3g
+#define DECL_0 227
+#define DECL_C1 -13104
+#define DECL_S1 2302
+#define DECL_C2 -221
+#define DECL_S2 30
+#define DECL_C3 -88
+#define DECL_S3 48
+
+// equation of time in 1/256 minute, the NOAA series times 229.18
+// 0.000075 + 0.001868 cos g - 0.032077 sin g - 0.014615 cos 2g - 0.040849 sin 2g
+#define EQT_0 4
+#define EQT_C1 110
+#define EQT_S1 -1882
+#define EQT_C2 -857
+#define EQT_S2 -2397
+
+
+// square root of a 32 bit value, bit by bit.
+static uint16_t isqrt32(uint32_t value)
+{
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+} // isqrt32
+
+
+// ----- Initialization and Default Values -----
+
+SunTimes::SunTimes(int16_t latitude, int16_t longitude, int16_t utcOffset)
+{
+  uint16_t angle = (int32_t)latitude * 65536 / 36000;
+  _sinLatitude = sinQ15(angle);
+  _cosLatitude = cosQ15(angle);
+  _longitude = longitude;
+  _utcOffset = utcOffset;
+
+  _sunrise = SUNTIMES_NONE;
+  _sunset = SUNTIMES_NONE;
+} // SunTimes()
+
+
+int16_t SunTimes::sinQ15(uint16_t angle)
+{
+  // fold into -pi/2 .. pi/2, where 16384 is pi/2, then z in Q15
+  int32_t z = (int16_t)angle;
+  if (z > 16384) {
+    z = 32768 - z;
+  } else if (z < -16384) {
+    z = -32768 - z;
+  }
+  z <<= 1;
+
+  int32_t z2 = (z * z) >> 15;
+  int32_t t = SIN_A5 - ((SIN_A7 * z2) >> 15);
+  t = SIN_A3 - ((t * z2) >> 15);
+  t = SIN_A1 - ((t * z2) >> 15);
+  t = (z * t) >> 15;
+
+  if (t > 32767) {
+    t = 32767;
+  } else if (t < -32767) {
+    t = -32767;
+  }
+  return t;
+} // sinQ15()
+
+
+int16_t SunTimes::cosQ15(uint16_t angle)
+{
+  return sinQ15(angle + 16384);
+} // cosQ15()
+
+
+int32_t SunTimes::acosQ15(int16_t value)
+{
+  int32_t x = (value < 0) ? -(int32_t)value : value;
+
+  int32_t p = ACOS_A2 - ((ACOS_A3 * x) >> 15);
+  p = ((p * x) >> 15) - ACOS_A1;
+  p = ACOS_A0 + ((p * x) >> 15);
+
+  int32_t root = isqrt32((uint32_t)(32768 - x) << 15);
+  int32_t result = (root * p) >> 15;
+
+  return (value < 0) ? PI_Q15 - result : result;
+} // acosQ15()
+
+
+bool SunTimes::compute(uint16_t dayOfYear)
+{
+  _sunrise = SUNTIMES_NONE;
+  _sunset = SUNTIMES_NONE;
+
+  // fractional year at noon, the year is taken as 365 days
+  uint16_t g = (uint32_t)(dayOfYear - 1) * 65536 / 365;
+  int32_t c1 = cosQ15(g);
+  int32_t s1 = sinQ15(g);
+  int32_t c2 = cosQ15(2 * g);
+  int32_t s2 = sinQ15(2 * g);
+  int32_t c3 = cosQ15(3 * g);
+  int32_t s3 = sinQ15(3 * g);
+
+  int32_t declination = DECL_0 + ((DECL_C1 * c1 + DECL_S1 * s1 + DECL_C2 * c2
+    + DECL_S2 * s2 + DECL_C3 * c3 + DECL_S3 * s3) >> 15);
+  int32_t equation = EQT_0 + ((EQT_C1 * c1 + EQT_S1 * s1 + EQT_C2 * c2 + EQT_S2 * s2) >> 15);
+
+  uint16_t angle = (declination * RAD_TO_ANGLE) >> 15;
+  int32_t sinDeclination = sinQ15(angle);
+  int32_t cosDeclination = cosQ15(angle);
+
+  // cos(hour angle) = (cos(zenith) - sin(lat) sin(decl)) / (cos(lat) cos(decl))
+  int32_t num = COS_ZENITH - ((_sinLatitude * sinDeclination) >> 15);
+  int32_t den = (_cosLatitude * cosDeclination) >> 15;
+  if ((den <= 0) || (num >= den) || (num <= -den)) {
+    return false; // the sun stays below or above the horizon
+  }
+  int32_t hourAngle = acosQ15((num << 15) / den);
+
+  // UTC of the solar noon and half the day in 1/16 minute, 4 minutes per degree of longitude
+  int32_t noon = 720L * 16 - (int32_t)_longitude * 16 / 25 - ((equation + 8) >> 4);
+  int32_t half = (hourAngle * MINUTES_PER_RAD_Q4) >> 15;
+
+  _sunrise = _toLocalMinute(noon - half);
+  _sunset = _toLocalMinute(noon + half);
+  return true;
+} // compute()
+
+
+bool SunTimes::isValid(void)
+{
+  return _sunrise != SUNTIMES_NONE;
+}
+
+
+int16_t SunTimes::getSunrise(void)
+{
+  return _sunrise;
+}
+
+
+int16_t SunTimes::getSunset(void)
+{
+  return _sunset;
+}
+
+
+// rounds to the minute and moves into the local day.
+int16_t SunTimes::_toLocalMinute(int32_t utcMinuteQ4)
+{
+  int16_t minute = ((utcMinuteQ4 + 8) >> 4) + _utcOffset;
+  minute %= 1440;
+  if (minute < 0) {
+    minute += 1440;
+  }
+  return minute;
+} // _toLocalMinute
+
+
+// end.
@@ -0,0 +1,64 @@
+// -----
+// SunTimes.h - Sunrise and sunset of a day at a fixed place, in integer
+// arithmetic only, so no floating point library is linked on the AVR.
+// The declination and the equation of time are the NOAA series of the
+// fractional year, with sine and cosine from a 7th order polynomial and the
+// hour angle from a polynomial arc cosine. The sunrise is the upper limb on
+// the horizon, with the standard refraction (zenith 90.833 degree).
+// Against the same formulas in double precision the results are within a
+// minute below the polar circles and within a few minutes around the days of
+// polar night and midnight sun. The formulas themselves are good to a few
+// minutes below the polar circles.
+// One compute() takes well below a millisecond, the caller computes once a
+// day and keeps the result. Without hardware access, so it is also built on
+// the host, see test/test_sun_times.
+// -----
+// 19.10.2026 created
+// 19.10.2026 7th order sine, host test
+// -----
+
+#ifndef SunTimes_h
+#define SunTimes_h
+
+#include <stdint.h>
+
+// no sunrise or sunset on the day, polar night or midnight sun
+#define SUNTIMES_NONE -1
+
+class SunTimes
+{
+public:
+  // ----- Constructor -----
+  // latitude and longitude in 1/100 degree, north and east are positive.
+  // utcOffset is the offset of the local clock from UTC in minutes, e.g. 60 for CET.
+  SunTimes(int16_t latitude, int16_t longitude, int16_t utcOffset);
+
+  // computes the times of the day of the year, 1 is January 1st.
+  // returns false when the sun does not rise and set on that day.
+  bool compute(uint16_t dayOfYear);
+
+  // true after a compute() of a day with a sunrise and a sunset.
+  bool isValid(void);
+
+  // minute of the local day, SUNTIMES_NONE when there is none.
+  int16_t getSunrise(void);
+  int16_t getSunset(void);
+
+  // sine and cosine of a binary angle (65536 is a full turn) in Q15.
+  static int16_t sinQ15(uint16_t angle);
+  static int16_t cosQ15(uint16_t angle);
+
+  // arc cosine of a Q15 value in radians, Q15.
+  static int32_t acosQ15(int16_t value);
+
+private:
+  int16_t _toLocalMinute(int32_t utcMinuteQ4);
+
+  int16_t _sinLatitude, _cosLatitude; // Q15
+  int16_t _longitude;                 // 1/100 degree
+  int16_t _utcOffset;                 // minutes
+
+  int16_t _sunrise, _sunset;
+};
+
+#endif
@@ -0,0 +1,111 @@
+// -----
+// TaskProfiler.cpp - Runtime statistics of the tasks of the cooperative
+// scheduler.
+// -----
+// 19.10.2026 created
+// 19.10.2026 log4 histogram, lines printed in two parts
+// -----
+
+#include "TaskProfiler.h"
+
+// ----- Initialization and Default Values -----
+
+TaskProfiler::TaskProfiler(TaskProfile *profiles, uint8_t count)
+{
+  _profiles = profiles;
+  _count = count;
+  _printLine = 0;
+  _printSecondPart = false;
+  reset();
+} // TaskProfiler
+
+
+void TaskProfiler::reset(void)
+{
+  memset(_profiles, 0, sizeof(TaskProfile) * _count);
+  for (uint8_t i = 0; i < _count; i++) {
+    _profiles[i].minMicros = 0xFFFF;
+  }
+} // reset
+
+
+void TaskProfiler::record(uint8_t index, unsigned long runtimeMicros)
+{
+  if (index >= _count)
+    return;
+
+  TaskProfile &profile = _profiles[index];
+  uint16_t runtime = (runtimeMicros > 0xFFFF) ? 0xFFFF : runtimeMicros;
+
+  if (profile.count == 0xFFFF)
+    return; // full until the next reset
+
+  profile.count++;
+  profile.sumMicros += runtime;
+  if (runtime < profile.minMicros)
+    profile.minMicros = runtime;
+  if (runtime > profile.maxMicros)
+    profile.maxMicros = runtime;
+
+  uint8_t bucket = 0;
+  while (runtime >>= 2)
+    bucket++;
+
+  if (profile.histogram[bucket] == 0xFF) {
+    // keep the shape of the histogram
+    for (uint8_t b = 0; b < TASKPROFILER_BUCKETS; b++)
+      profile.histogram[b] >>= 1;
+  }
+  profile.histogram[bucket]++;
+} // record
+
+
+bool TaskProfiler::printCsvLine(Print &out, const char * const *names)
+{
+  if (_printLine == 0) {
+    if (!_printSecondPart) {
+      out.print(F("# profile ms="));
+      out.println(millis());
+      _printSecondPart = true;
+      return false;
+    }
+    out.println(F("task,count,min_us,avg_us,max_us,h0,h1,h2,h3,h4,h5,h6,h7"));
+    _printSecondPart = false;
+    _printLine = 1;
+    return false;
+  }
+
+  uint8_t i = _printLine - 1;
+  TaskProfile &profile = _profiles[i];
+
+  if (!_printSecondPart) {
+    out.print((const __FlashStringHelper *)pgm_read_ptr(&names[i]));
+    out.print(',');
+    out.print(profile.count);
+    out.print(',');
+    out.print(profile.count ? profile.minMicros : 0);
+    out.print(',');
+    out.print(profile.count ? profile.sumMicros / profile.count : 0);
+    out.print(',');
+    out.print(profile.maxMicros);
+    _printSecondPart = true;
+    return false;
+  }
+
+  for (uint8_t b = 0; b < TASKPROFILER_BUCKETS; b++) {
+    out.print(',');
+    out.print(profile.histogram[b]);
+  }
+  out.println();
+  _printSecondPart = false;
+
+  if (++_printLine > _count) {
+    _printLine = 0;
+    reset();
+    return true;
+  }
+  return false;
+} // printCsvLine
+
+
+// end.
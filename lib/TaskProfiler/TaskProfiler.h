@@ -0,0 +1,56 @@
+// -----
+// TaskProfiler.h - Runtime statistics of the tasks of the cooperative
+// scheduler: min/avg/max in microseconds and a log4 histogram per task,
+// printed as CSV frame for the Serial monitor.
+// -----
+// 19.10.2026 created
+// 19.10.2026 log4 histogram, lines printed in two parts
+// -----
+
+#ifndef TaskProfiler_h
+#define TaskProfiler_h
+
+#include "Arduino.h"
+
+// bucket k counts runtimes from 4^k to 4^(k+1)-1 us, bucket 0 includes 0 us.
+// 8 buckets cover the 16 bit runtimes with 18 bytes per task.
+#define TASKPROFILER_BUCKETS 8
+
+struct TaskProfile {
+  uint16_t count;
+  uint16_t minMicros;
+  uint16_t maxMicros;
+  uint32_t sumMicros;
+  uint8_t histogram[TASKPROFILER_BUCKETS]; // halved when a bucket is full.
+};
+
+class TaskProfiler
+{
+public:
+  // ----- Constructor -----
+  TaskProfiler(TaskProfile *profiles, uint8_t count);
+
+  // adds one runtime of the entry, callable as CoopScheduler run hook.
+  void record(uint8_t index, unsigned long runtimeMicros);
+
+  // starts a new measurement.
+  void reset(void);
+
+  /**
+   * @brief Print the next part of the CSV frame, header first, then one line
+   * per entry: name,count,min_us,avg_us,max_us,h0..h7
+   * Every line is printed in two parts of at most 60 bytes, so a part fits
+   * into the 64 byte Serial buffer and never blocks the tasks.
+   * @param names entry names in PROGMEM, same order as the entries.
+   * @return true when the frame is complete, the statistics are reset then.
+   */
+  bool printCsvLine(Print &out, const char * const *names);
+
+private:
+  TaskProfile *_profiles;
+  uint8_t _count;
+  uint8_t _printLine; // next line of the frame, 0 is the header
+  bool _printSecondPart;
+};
+
+#endif
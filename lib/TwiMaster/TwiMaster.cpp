@@ -0,0 +1,206 @@
+// -----
+// TwiMaster.cpp - Polled I2C (TWI) master writer with bounded latency.
+// -----
+// 19.10.2026 created
+// -----
+
+#include "TwiMaster.h"
+
+// status codes of the TWI in master transmitter mode (TWSR & 0xF8)
+#define TWI_START 0x08
+#define TWI_REP_START 0x10
+#define TWI_SLA_ACK 0x18
+#define TWI_SLA_NACK 0x20
+#define TWI_DATA_ACK 0x28
+#define TWI_DATA_NACK 0x30
+#define TWI_ARB_LOST 0x38
+#define TWI_BUS_ERROR 0x00
+
+// half of a 100 kHz clock period for the recovery pulses
+#define TWI_RECOVER_HALF_MICROS 5
+
+TwiMaster Twi;
+
+// ----- Initialization and Default Values -----
+
+TwiMaster::TwiMaster()
+{
+  _twbr = 72; // 100 kHz at 16 MHz
+  memset(_errors, 0, sizeof(_errors));
+  _recoveries = 0;
+} // TwiMaster
+
+
+void TwiMaster::begin(uint32_t frequency)
+{
+  _twbr = ((F_CPU / frequency) - 16) / 2;
+
+  pinMode(SDA, INPUT_PULLUP);
+  pinMode(SCL, INPUT_PULLUP);
+
+  TWSR = 0; // prescaler 1
+  TWBR = _twbr;
+  TWCR = _BV(TWEN);
+} // begin
+
+
+TwiMaster::Status TwiMaster::write(uint8_t address, const uint8_t *data, uint8_t length)
+{
+  Status status = _transmit(address, data, length);
+
+  if (status != OK) {
+    if (_errors[status] < 0xFFFF) {
+      _errors[status]++;
+    }
+    if ((status == NACK_ADDRESS) || (status == NACK_DATA)) {
+      // the bus works, just release it
+      if (!_stop()) {
+        recover();
+      }
+    } else {
+      recover();
+    }
+  }
+  return status;
+} // write
+
+
+TwiMaster::Status TwiMaster::_transmit(uint8_t address, const uint8_t *data, uint8_t length)
+{
+  uint8_t twst;
+
+  TWCR = _BV(TWINT) | _BV(TWSTA) | _BV(TWEN);
+  if (!_wait()) {
+    return TIMEOUT;
+  }
+  twst = TWSR & 0xF8;
+  if (twst == TWI_ARB_LOST) {
+    return ARBITRATION_LOST;
+  }
+  if ((twst != TWI_START) && (twst != TWI_REP_START)) {
+    return BUS_ERROR;
+  }
+
+  TWDR = address << 1; // write
+  TWCR = _BV(TWINT) | _BV(TWEN);
+  if (!_wait()) {
+    return TIMEOUT;
+  }
+  twst = TWSR & 0xF8;
+  if (twst == TWI_SLA_NACK) {
+    return NACK_ADDRESS;
+  }
+  if (twst == TWI_ARB_LOST) {
+    return ARBITRATION_LOST;
+  }
+  if (twst != TWI_SLA_ACK) {
+    return BUS_ERROR;
+  }
+
+  for (uint8_t i = 0; i < length; i++) {
+    TWDR = data[i];
+    TWCR = _BV(TWINT) | _BV(TWEN);
+    if (!_wait()) {
+      return TIMEOUT;
+    }
+    twst = TWSR & 0xF8;
+    if (twst == TWI_DATA_NACK) {
+      return NACK_DATA;
+    }
+    if (twst == TWI_ARB_LOST) {
+      return ARBITRATION_LOST;
+    }
+    if (twst != TWI_DATA_ACK) {
+      return BUS_ERROR;
+    }
+  } // for
+
+  return _stop() ? OK : TIMEOUT;
+} // _transmit
+
+
+// waits for the end of the current step of the transaction.
+bool TwiMaster::_wait(void)
+{
+  unsigned long start = micros();
+
+  while (!(TWCR & _BV(TWINT))) {
+    if (micros() - start > TWIMASTER_TIMEOUT_MICROS) {
+      return false;
+    }
+  }
+  return true;
+} // _wait
+
+
+bool TwiMaster::_stop(void)
+{
+  unsigned long start = micros();
+
+  TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWSTO);
+  while (TWCR & _BV(TWSTO)) {
+    if (micros() - start > TWIMASTER_TIMEOUT_MICROS) {
+      return false;
+    }
+  }
+  return true;
+} // _stop
+
+
+void TwiMaster::recover(void)
+{
+  // take the pins back from the TWI, released lines are pulled up
+  TWCR = 0;
+  pinMode(SDA, INPUT_PULLUP);
+  pinMode(SCL, INPUT_PULLUP);
+
+  // a slave holding SDA low is clocked until it has shifted out its byte
+  for (uint8_t i = 0; (i < 9) && !digitalRead(SDA); i++) {
+    digitalWrite(SCL, LOW);
+    pinMode(SCL, OUTPUT);
+    delayMicroseconds(TWI_RECOVER_HALF_MICROS);
+    pinMode(SCL, INPUT_PULLUP);
+    delayMicroseconds(TWI_RECOVER_HALF_MICROS);
+  }
+
+  // STOP: SDA rises while SCL is high
+  digitalWrite(SDA, LOW);
+  pinMode(SDA, OUTPUT);
+  delayMicroseconds(TWI_RECOVER_HALF_MICROS);
+  pinMode(SDA, INPUT_PULLUP);
+  delayMicroseconds(TWI_RECOVER_HALF_MICROS);
+
+  TWSR = 0;
+  TWBR = _twbr;
+  TWCR = _BV(TWEN);
+
+  if (_recoveries < 0xFFFF) {
+    _recoveries++;
+  }
+} // recover
+
+
+uint16_t TwiMaster::getErrors(Status status)
+{
+  return (status < STATUS_COUNT) ? _errors[status] : 0;
+}
+
+
+uint16_t TwiMaster::getErrorCount(void)
+{
+  uint16_t count = 0;
+
+  for (uint8_t i = 1; i < STATUS_COUNT; i++) {
+    count += _errors[i];
+  }
+  return count;
+}
+
+
+uint16_t TwiMaster::getRecoveries(void)
+{
+  return _recoveries;
+}
+
+
+// end.
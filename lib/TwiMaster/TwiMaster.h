@@ -0,0 +1,63 @@
+// -----
+// TwiMaster.h - Polled I2C (TWI) master writer with bounded latency.
+// Every wait for the bus has a timeout, so a held SDA line, a lost
+// arbitration or a missing device cannot hang the caller like Wire does.
+// After a timeout or bus error the bus is recovered with 9 SCL pulses and
+// a STOP. Errors are counted per kind.
+// -----
+// 19.10.2026 created
+// -----
+
+#ifndef TwiMaster_h
+#define TwiMaster_h
+
+#include "Arduino.h"
+
+// longest wait for one step of a transaction, a byte takes 90 us at 100 kHz.
+#define TWIMASTER_TIMEOUT_MICROS 1000
+
+class TwiMaster
+{
+public:
+  enum Status : uint8_t {
+    OK = 0,
+    NACK_ADDRESS,     // no device answered
+    NACK_DATA,        // device refused a byte
+    ARBITRATION_LOST, // another master or a disturbed line
+    BUS_ERROR,        // illegal START or STOP on the bus
+    TIMEOUT,          // the bus did not move, e.g. SDA or SCL held low
+    STATUS_COUNT
+  };
+
+  // ----- Constructor -----
+  TwiMaster();
+
+  // enables the TWI and the pullups of SDA and SCL.
+  void begin(uint32_t frequency = 100000);
+
+  /**
+   * @brief Send the bytes to the device in one transaction.
+   * Takes at most (length + 3) * TWIMASTER_TIMEOUT_MICROS plus the recovery.
+   */
+  Status write(uint8_t address, const uint8_t *data, uint8_t length);
+
+  // clocks a stuck slave free with 9 SCL pulses and sends a STOP.
+  void recover(void);
+
+  uint16_t getErrors(Status status);
+  uint16_t getErrorCount(void);
+  uint16_t getRecoveries(void);
+
+private:
+  Status _transmit(uint8_t address, const uint8_t *data, uint8_t length);
+  bool _wait(void);
+  bool _stop(void);
+
+  uint8_t _twbr;
+  uint16_t _errors[STATUS_COUNT];
+  uint16_t _recoveries;
+};
+
+extern TwiMaster Twi;
+
+#endif
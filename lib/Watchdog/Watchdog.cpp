@@ -0,0 +1,90 @@
+// -----
+// Watchdog.cpp - Supervision of the cooperative scheduler by the AVR watchdog.
+// -----
+// 19.10.2026 created
+// 19.10.2026 reset cause handed over by Optiboot
+// -----
+
+#include "Watchdog.h"
+
+// .noinit is neither cleared nor copied at boot, so both survive a reset
+// and are set before .bss is cleared.
+static uint8_t resetCause __attribute__((section(".noinit")));
+static uint8_t bootloaderCause __attribute__((section(".noinit")));
+static volatile uint8_t breadcrumb __attribute__((section(".noinit")));
+
+
+// Runs first after the reset vector: Optiboot reads and clears MCUSR itself
+// and hands its value over in r2. Only r2 is stored, the zero register and
+// the stack are not set up yet.
+void watchdogBootloaderCause(void) __attribute__((naked, used, section(".init0")));
+
+void watchdogBootloaderCause(void)
+{
+  __asm__ __volatile__ ("sts %0, r2\n" : "=m" (bootloaderCause) :);
+} // watchdogBootloaderCause
+
+
+// Runs before main(): after a watchdog reset the watchdog stays enabled with
+// the shortest timeout, so it must be stopped before the constructors run.
+void watchdogBoot(void) __attribute__((naked, used, section(".init3")));
+
+void watchdogBoot(void)
+{
+  resetCause = MCUSR;
+  if (resetCause == 0) {
+    // cleared by the bootloader
+    resetCause = bootloaderCause;
+  }
+  MCUSR = 0;
+  wdt_disable();
+} // watchdogBoot
+
+
+// ----- Initialization and Default Values -----
+
+Watchdog::Watchdog()
+{
+  // the breadcrumb is random after power-on
+  _lastTask = (resetCause & _BV(WDRF)) ? breadcrumb : WATCHDOG_NO_TASK;
+  breadcrumb = WATCHDOG_NO_TASK;
+} // Watchdog
+
+
+void Watchdog::begin(uint8_t timeout)
+{
+  wdt_enable(timeout);
+} // begin
+
+
+void Watchdog::feed(void)
+{
+  wdt_reset();
+} // feed
+
+
+volatile uint8_t *Watchdog::getBreadcrumb(void)
+{
+  return &breadcrumb;
+}
+
+
+uint8_t Watchdog::getResetCause(void)
+{
+  return resetCause;
+}
+
+
+bool Watchdog::wasWatchdogReset(void)
+{
+  return resetCause & _BV(WDRF);
+}
+
+
+uint8_t Watchdog::getLastTask(void)
+{
+  return _lastTask;
+}
+
+
+// end.
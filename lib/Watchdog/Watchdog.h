@@ -0,0 +1,48 @@
+// -----
+// Watchdog.h - Supervision of the cooperative scheduler by the AVR watchdog.
+// The reset cause (MCUSR) is captured before main(), from r2 when Optiboot
+// has already read and cleared MCUSR, and a breadcrumb in
+// .noinit SRAM keeps the task that was running when the watchdog fired.
+// -----
+// 19.10.2026 created
+// 19.10.2026 reset cause handed over by Optiboot
+// -----
+
+#ifndef Watchdog_h
+#define Watchdog_h
+
+#include "Arduino.h"
+#include <avr/wdt.h>
+
+// breadcrumb value outside of the tasks
+#define WATCHDOG_NO_TASK 0xFF
+
+class Watchdog
+{
+public:
+  // ----- Constructor -----
+  Watchdog();
+
+  // arms the watchdog, timeout is one of WDTO_15MS .. WDTO_8S.
+  void begin(uint8_t timeout);
+
+  // restarts the timeout, call once per scheduler pass.
+  void feed(void);
+
+  // where the scheduler writes the index of the task it enters.
+  volatile uint8_t *getBreadcrumb(void);
+
+  // MCUSR as it was at boot.
+  uint8_t getResetCause(void);
+
+  // the last reset was made by the watchdog.
+  bool wasWatchdogReset(void);
+
+  // task running when the watchdog fired, WATCHDOG_NO_TASK if none.
+  uint8_t getLastTask(void);
+
+private:
+  uint8_t _lastTask;
+};
+
+#endif
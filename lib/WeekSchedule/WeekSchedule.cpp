@@ -0,0 +1,91 @@
+// -----
+// WeekSchedule.cpp - Start times of a week, compiled into one sorted array.
+// -----
+// 19.10.2026 created
+// -----
+
+#include "WeekSchedule.h"
+
+// ----- Initialization and Default Values -----
+
+WeekSchedule::WeekSchedule()
+{
+  _count = 0;
+}
+
+
+void WeekSchedule::clear(void)
+{
+  _count = 0;
+}
+
+
+bool WeekSchedule::add(uint16_t minuteOfDay, uint8_t weekdays, uint8_t ref)
+{
+  for (uint8_t day = 0; day < 7; day++) {
+    if (!(weekdays & _BV(day)))
+      continue;
+
+    if (_count >= WEEKSCHEDULE_MAX_EVENTS)
+      return false;
+
+    _events[_count].minute = day * WEEKSCHEDULE_MINUTES_PER_DAY + minuteOfDay;
+    _events[_count].ref = ref;
+    _count++;
+  }
+  return true;
+} // add
+
+
+// insertion sort, the array is small and sorted only when the settings are saved.
+// equal minutes keep the order they were added in.
+void WeekSchedule::sort(void)
+{
+  for (uint8_t i = 1; i < _count; i++) {
+    WeekEvent event = _events[i];
+    uint8_t j = i;
+    while ((j > 0) && (_events[j - 1].minute > event.minute)) {
+      _events[j] = _events[j - 1];
+      j--;
+    }
+    _events[j] = event;
+  }
+} // sort
+
+
+uint8_t WeekSchedule::getCount(void)
+{
+  return _count;
+}
+
+
+const WeekEvent &WeekSchedule::getEvent(uint8_t index)
+{
+  return _events[index];
+}
+
+
+uint8_t WeekSchedule::lowerBound(uint16_t minute)
+{
+  uint8_t low = 0;
+  uint8_t high = _count;
+
+  while (low < high) {
+    uint8_t middle = (low + high) / 2;
+    if (_events[middle].minute < minute) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+} // lowerBound
+
+
+uint16_t WeekSchedule::minuteOfWeek(uint8_t wday, uint8_t hour, uint8_t minute)
+{
+  return (wday - 1) * WEEKSCHEDULE_MINUTES_PER_DAY + hour * 60 + minute;
+} // minuteOfWeek
+
+
+// end.
@@ -0,0 +1,60 @@
+// -----
+// WeekSchedule.h - Start times of a week, compiled into one sorted array.
+// Every start time with its weekday mask is added as one event per day, and
+// the events are sorted once after the last add(). The event at or after a
+// minute of the week is then found by a binary search.
+// The reference of an event is free for the caller, e.g. pump and slot.
+// -----
+// 19.10.2026 created
+// -----
+
+#ifndef WeekSchedule_h
+#define WeekSchedule_h
+
+#include "Arduino.h"
+
+// 2 pumps with 4 slots on every day
+#define WEEKSCHEDULE_MAX_EVENTS 56
+
+#define WEEKSCHEDULE_MINUTES_PER_DAY 1440
+#define WEEKSCHEDULE_MINUTES_PER_WEEK 10080
+
+struct WeekEvent {
+  uint16_t minute; // minute of the week, 0 is Sunday 0:00
+  uint8_t ref;
+};
+
+class WeekSchedule
+{
+public:
+  // ----- Constructor -----
+  WeekSchedule();
+
+  // removes all events, call before adding a new set.
+  void clear(void);
+
+  /**
+   * @brief Adds an event at minuteOfDay on every day of the weekday mask.
+   * Bit 0 of weekdays is Sunday, like Wday - 1 of TimeLib.
+   * Returns false when the array is full, the rest of the days are left out.
+   */
+  bool add(uint16_t minuteOfDay, uint8_t weekdays, uint8_t ref);
+
+  // sorts the events by their minute, call after the last add().
+  void sort(void);
+
+  uint8_t getCount(void);
+  const WeekEvent &getEvent(uint8_t index);
+
+  // index of the first event at or after the minute of the week, getCount() if there is none.
+  uint8_t lowerBound(uint16_t minute);
+
+  // wday is 1 for Sunday, like TimeLib.
+  static uint16_t minuteOfWeek(uint8_t wday, uint8_t hour, uint8_t minute);
+
+private:
+  WeekEvent _events[WEEKSCHEDULE_MAX_EVENTS];
+  uint8_t _count;
+};
+
+#endif
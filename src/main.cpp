@@ -2,67 +2,242 @@
 #include <customChars.h>
 #include <pinout.h>
 #include <LiquidCrystal_I2C.h>
+#include <LcdFrame.h>
+#include <TwiMaster.h>
 #include <Time.h>
 #include <DS1302RTC.h>
 #include <OneButton.h>
 #include <RotaryEncoder.h>
+#include <ButtonBank.h>
+#include <CoopScheduler.h>
+#include <PowerManager.h>
+#include <PumpTimer.h>
+#include <PumpDispatcher.h>
+#include <FlowMeter.h>
+#include <MoistureSensors.h>
+#include <DS18B20.h>
+#include <SunTimes.h>
+#include <WeekSchedule.h>
+#include <RelayBank.h>
+#include <RelayShiftOutput.h>
+#include <RelayExpanderOutput.h>
+#include <JitterMonitor.h>
+#include <MemoryMonitor.h>
+#include <Watchdog.h>
 #include <EEPROM.h>
 #include <avdweb_VirtualDelay.h>
-
-class Pump {
-    int pumpPin;
-
-    public:
-    Pump(int pin) {
-        pumpPin = pin;
-        pinMode(pumpPin, OUTPUT);
-        digitalWrite(pumpPin, HIGH);
-    }
-
-    void startWater() {
-        if (digitalRead(pumpPin) == HIGH) {
-            digitalWrite(pumpPin, LOW); // turns ON the pump
-        }
-    }
-
-    void stopWater() {
-        if (digitalRead(pumpPin) == LOW) {
-            digitalWrite(pumpPin, HIGH); // turns OFF the pump
-        }
-    }
-};
+#ifdef PLANTPUMPER_PROFILE
+#include <TaskProfiler.h>
+#include <DutyCycleModel.h>
+#endif
 
 // Set the LCD address to 0x27 in PCF8574 by NXP and Set to 0x3F in PCF8574A by Ti
 LiquidCrystal_I2C lcd(0x27, 16, 2);
+// everything is drawn to the frame, lcdTick() sends it to the LCD
+LcdFrame screen(lcd);
+// LCD is initialized in the background by lcdTick()
+bool lcdReady = false;
+// next custom character to create during the initialization
+uint8_t customCharLocation = 0;
+// initializations repeated after the I2C bus failed
+uint16_t lcdRestarts = 0;
+// characters sent to the LCD per lcdTick(), about 0.7 ms each
+uint8_t lcdWritesPerTick = 2;
 // Set RTC module
 DS1302RTC rtc(RTC_RST, RTC_DAT, RTC_CLK);
 // Set Rotary Encoder
-RotaryEncoder encoder(ROTARYENCODER_PIN1, ROTARYENCODER_PIN2);
+RotaryEncoder encoder(ROTARYENCODER_PIN1, ROTARYENCODER_PIN2, RotaryEncoder::LatchMode::FOUR3);
 OneButton rotaryButton(ROTARYENCODER_BUTTON, true);
+// "water now" buttons, one per pump
+ButtonBank waterNowButtons;
+
+PowerManager power;
+
+// stack high-water mark and free SRAM
+MemoryMonitor memory;
+
+// resets the controller when a task hangs, fed after every scheduler pass
+// 1 s covers the longest task and the sleep between the tasks (50 ms at most)
+// the longest task saves the settings: 89 bytes at 3.3 ms per changed byte,
+// about 300 ms when every byte changed
+Watchdog watchdog;
+// watchdog resets logged in EEPROM
+uint16_t watchdogResets = 0;
+uint8_t lastIncidentTask = WATCHDOG_NO_TASK;
 
 VirtualDelay vDelay;
 int vDelayDuration = 4000;
 
+// encoder steps not yet applied to the edited field
+int pendingEdit = 0;
+
+// timed message shown instead of the cycling screens
+bool splashActive = false;
+unsigned long splashStartMillis = 0;
+unsigned int splashDuration = 0;
+
 VirtualDelay lcdBacklightDelay;
 unsigned int backlightDelayDuration = 30000;
 unsigned long backlightPreviousMillis = 0;
 
-// initializes the pumps
+// initializes the pumps, relays are active-low
 int pumpCount = 2;
-Pump pump1(RELAY1);
-Pump pump2(RELAY2);
-Pump pump[2] = {pump1, pump2};
-
-// initializes two sets of variables used in the timers
-// first timer at position 0, second timer at position 1
-uint8_t startHour[2] = {0, 0};
-uint8_t startMinute[2] = {0, 0};
-uint8_t duration[2] = {0, 0};
+#if defined(RELAYS_SHIFT_REGISTER)
+RelayShiftOutput relayOutput(SHIFT_DATA, SHIFT_CLOCK, SHIFT_LATCH, 1, true);
+#elif defined(RELAYS_EXPANDER)
+RelayExpanderOutput relayOutput(RELAY_EXPANDER_ADDRESS, 1, true);
+#else
+const RelayChannel relayChannels[2] = {
+    RELAYBANK_CHANNEL(RELAY1, true),
+    RELAYBANK_CHANNEL(RELAY2, true)
+};
+RelayPortOutput relayOutput(relayChannels, 2);
+#endif
+// relays on pins or shift registers are off from the start of the constructors
+RelayBank relays(relayOutput, 2);
+
+// millis() when the run of the pump was ended by pumpTimer
+volatile unsigned long pumpStopMillis[2] = {0, 0};
+
+/**
+ * stops the pump at the end of its run, called from the Timer1 interrupt
+ * or from the flow meter at the target volume
+ * relays on the I2C bus are switched by the next pumpWatcher(), within 10 ms
+**/
+void pumpTimerStop(uint8_t channel) {
+    relays.set(channel, false);
+    relays.applyFromInterrupt();
+    pumpStopMillis[channel] = millis();
+}
+
+// ends the runs of the pumps in the Timer1 interrupt, independent of the loop
+PumpTimer pumpTimer(pumpTimerStop);
+
+// the supply drives one pump at a time, runs that do not fit wait in the queue
+// weights are the pump currents in the same unit as the budget
+const uint16_t pumpBudget = 1;
+const uint16_t pumpWeight[2] = {1, 1};
+const uint8_t pumpPriority[2] = {0, 0};
+// minimum time between two starts, the inrush current has settled
+const uint16_t pumpStaggerMillis = 1000;
+PumpDispatcher dispatcher(2, pumpBudget, pumpStaggerMillis);
+
+// volume of the runs, a run with a target volume stops at the target
+// and its duration is the time cap, e.g. when the tank is empty
+const uint16_t flowPulsesPerLitre = 450;
+const uint32_t targetMillilitres[2] = {0, 0}; // 0 runs for the duration only
+FlowMeter flow(FLOW_SENSOR, flowPulsesPerLitre, pumpTimerStop);
+
+// soil moisture of the pumps, the probes are powered once a minute
+const uint8_t moisturePins[2] = {MOISTURE_PROBE1, MOISTURE_PROBE2};
+MoistureSensors moisture(moisturePins, 2, MOISTURE_POWER);
+// 13 bit readings of a capacitive probe in air and in water
+const uint16_t moistureDryRaw = 4200;
+const uint16_t moistureWetRaw = 2000;
+// a scheduled run is skipped when the soil is wetter than skipAbove percent
+// and lengthened to moistureExtendPercent when it is drier than extendBelow
+const uint8_t moistureSkipAbove[2] = {100, 100}; // 100 never skips
+const uint8_t moistureExtendBelow[2] = {0, 0};   // 0 never extends
+const uint16_t moistureExtendPercent = 150;
+uint16_t moistureSkips[2] = {0, 0};
+uint16_t moistureExtends[2] = {0, 0};
+
+// air temperature, a conversion is started every 30 s and read 750 ms later
+DS18B20 thermometer(TEMPERATURE_SENSOR);
+// length of a scheduled run in percent of its duration by temperature,
+// linear between the points and flat outside, e.g. {{15, 80}, {25, 100}, {35, 150}}
+// edited in the menu and saved with the settings, the points rise in temperature
+struct HeatPoint {
+    int8_t celsius;
+    uint8_t percent;
+};
+const uint8_t heatPointCount = 3;
+const HeatPoint heatCurveDefault[heatPointCount] = {{15, 100}, {25, 100}, {35, 100}};
+HeatPoint heatCurve[2][heatPointCount] = {
+    {{15, 100}, {25, 100}, {35, 100}},
+    {{15, 100}, {25, 100}, {35, 100}}
+};
+// limits of the editor, two characters of degrees and three of percent
+const int8_t heatCelsiusMin = -9;
+const int8_t heatCelsiusMax = 50;
+const uint8_t heatPercentMin = 10;
+const uint8_t heatPercentMax = 250;
+
+// place of the garden for the sunrise and sunset, 1/100 degree, north and east are positive
+// the RTC is ahead of UTC by sunUtcOffset minutes, it is not moved for the summer time
+const int16_t sunLatitude = 5008;
+const int16_t sunLongitude = 1442;
+const int16_t sunUtcOffset = 60;
+SunTimes sun(sunLatitude, sunLongitude, sunUtcOffset);
+// day of the computed sun times, days since 1970, see updateSunTimes()
+uint16_t sunDay = 0;
+
+// start of a weekday slot: clock time, or offset from the sunrise or sunset of the day
+enum SlotBase : uint8_t {
+    BASE_CLOCK,
+    BASE_SUNRISE,
+    BASE_SUNSET
+};
+const uint8_t baseCount = 3;
+// the offset is before the sunrise or sunset
+const uint8_t baseBefore = 0x80;
+// offsets up to 9:59, one digit of hours fits the pump screen
+const uint8_t sunOffsetHoursMax = 9;
+
+// watering slots of the pumps, a pump starts at every slot on the days of its weekday mask
+// or, for an interval slot, every periodHours from the start time on its anchor day
+// first pump at position 0, second pump at position 1
+struct ScheduleSlot {
+    uint8_t weekdays; // bit 0 is Sunday, like Wday - 1, slotInterval marks an interval slot
+    uint8_t startHour; // or hours of the offset from the sunrise or sunset
+    uint8_t startMinute;
+    uint16_t duration; // seconds
+    uint8_t periodHours; // interval slot: hours between the starts
+    uint16_t anchorDay; // interval slot: day of the first start, days since 1970
+    uint8_t timeBase; // weekday slot: SlotBase, with baseBefore for an offset before the sun
+};
+const uint8_t slotInterval = 0x80;
+const uint8_t slotMax = 4;
+ScheduleSlot slots[2][slotMax];
+uint8_t slotCount[2] = {1, 1};
+const uint16_t durationMax = 4 * 3600;
 uint8_t isOn[2] = {0, 0};
-uint8_t calendar[2][7] = {{0, 0, 0, 0, 0, 0, 0}, {0, 0, 0, 0, 0, 0, 0}};
+// starts of the weekday slots of the enabled pumps in the week, see compileSchedule()
+WeekSchedule schedule;
+// interval slots of the enabled pumps as pump * slotMax + slot
+uint8_t intervalRefs[2 * slotMax];
+uint8_t intervalCount = 0;
+// interval slots with an edited start, bit per slot, anchored to the day of the save
+uint8_t intervalEdited[2] = {0, 0};
 
 bool pumpActive[2] = {false, false};
 
+// offset of the relay edges from the scheduled second, per pump
+JitterMonitor pumpJitter;
+// the scheduled start of the current minute was handled, used for counting missed starts
+bool scheduleSlotDone[2] = {false, false};
+// millis() of the last RTC read still showing the previous second
+// the current second started after it, so the measured offsets are upper bounds
+unsigned long secondStartMillis = 0;
+
+// length of the next run of the pump in milliseconds, set together with pumpActive
+unsigned long runMillis[2] = {0, 0};
+
+// what to do with a watering window, which was missed during a power loss or a stall
+enum CatchUpPolicy : uint8_t {
+    CATCHUP_SKIP,      // wait for the next window
+    CATCHUP_REMAINING, // run until the end of the window, if it is not over yet
+    CATCHUP_FULL       // run the full duration
+};
+const CatchUpPolicy catchUpPolicy = CATCHUP_REMAINING;
+// windows which started longer ago are always skipped
+const unsigned long catchUpMaxAge = 6 * SECS_PER_HOUR;
+// time of the last schedule evaluation, also kept in the RAM of the RTC, 0 if unknown
+time_t lastEvaluatedTime = 0;
+time_t lastSavedEvaluation = 0;
+// seconds the pumps still had to run at the saved evaluation, read at boot
+uint16_t savedRemainingSeconds[2] = {0, 0};
+
 char calendar_on[7] = {'S', 'M', 'T', 'W', 'T', 'F', 'S'};
 char calendar_off[7] = {'s', 'm', 't', 'w', 't', 'f', 's'};
 
@@ -72,6 +247,11 @@ char convertedCalendar[7];
 
 // stores actual time
 tmElements_t actualTime;
+// actualTime was read from the RTC at least once
+bool clockValid = false;
+// millis() when the schedule was evaluated for the first time after boot
+bool scheduleEvaluated = false;
+unsigned long firstEvaluationMillis = 0;
 
 tmElements_t newTime;
 
@@ -79,26 +259,48 @@ tmElements_t newTime;
 bool isEditing = false;
 bool isEditingCalendar = false;
 bool isMenu = false;
+// diagnostics screen is shown instead of an editor, encoder selects the page
+bool isDiagnostics = false;
+uint8_t diagnosticsPage = 0;
+const uint8_t diagnosticsPageCount = 9;
 // this is cycler between time, pump1 and pump2
 int cycler = 0;
 
+// menu entries: time and date, pumps, heat curves of the pumps and diagnostics
 uint8_t menuPosition = 0;
+const uint8_t menuHeat = 3; // heat curve of the first pump, the second one follows
+const uint8_t menuDiagnostics = 5;
 int editingPosition = 0;
+// slot shown and edited on the pump screen
+uint8_t editedSlot = 0;
 int calendarPosition = 0;
-int cursorPositionsPumpLength = 11;
-int cursorPositionsPump[11][2] = {
+int cursorPositionsPumpLength = 15;
+int cursorPositionsPump[15][2] = {
     // first pump screen
-    {3, 0}, // Hours
+    {0, 1}, // Slot
+    {2, 0}, // Clock or sun
+    {3, 0}, // Hours, or sign and hours of the offset
     {6, 0}, // Minutes
-    {12, 0}, // Duration
-    {3, 1}, // Monday
-    {4, 1}, // Tuesday
-    {5, 1}, // Wednesday
-    {6, 1}, // Thursday
-    {7, 1}, // Friday, Friday, let's get down on Friday
-    {8, 1}, // Saturday
-    {9, 1}, // Sunday
-    {11, 1} // On/Off
+    {15, 0}, // Duration
+    {2, 1}, // Weekdays or interval
+    {3, 1}, // Sunday, or hours of the interval
+    {4, 1}, // Monday
+    {5, 1}, // Tuesday
+    {6, 1}, // Wednesday
+    {7, 1}, // Thursday
+    {8, 1}, // Friday, Friday, let's get down on Friday
+    {9, 1}, // Saturday
+    {11, 1}, // On/Off
+    {15, 1} // Slot count
+};
+int cursorPositionsHeatLength = 6;
+int cursorPositionsHeat[6][2] = {
+    {2, 0}, // degrees of the first point
+    {2, 1}, // percent of the first point
+    {7, 0}, // second point
+    {7, 1},
+    {12, 0}, // third point
+    {12, 1}
 };
 int cursorPositionTimeLength = 5;
 int cursorPositionTime[5][2] = {
@@ -110,71 +312,460 @@ int cursorPositionTime[5][2] = {
 };
 
 /**
- * inits custom characters for LCD. Max 8 custom characters :(
+ * acceleration curve of an edited value
+ * detents closer than fastMillis move the value by fastStep,
+ * detents closer than mediumMillis by mediumStep, slower rotation by 1
+**/
+struct AccelerationCurve {
+    uint16_t mediumMillis;
+    uint8_t mediumStep;
+    uint16_t fastMillis;
+    uint8_t fastStep;
+};
+
+const AccelerationCurve accelerationNone = {0, 1, 0, 1};
+const AccelerationCurve accelerationSmall = {100, 2, 40, 5}; // day, month, hour
+const AccelerationCurve accelerationLarge = {100, 5, 40, 10}; // year, minute
+const AccelerationCurve accelerationDuration = {100, 10, 40, 60}; // duration in seconds
+const AccelerationCurve accelerationInterval = {100, 2, 40, 12}; // hours of the interval
+
+// acceleration curves of the fields, same order as the cursor positions
+const AccelerationCurve *accelerationPump[15] = {
+    &accelerationNone, // Slot
+    &accelerationNone, // Clock or sun
+    &accelerationSmall, // Hours
+    &accelerationLarge, // Minutes
+    &accelerationDuration, // Duration
+    &accelerationNone, // Weekdays or interval
+    &accelerationNone, // Sunday, see accelerationInterval
+    &accelerationNone, // Monday
+    &accelerationNone, // Tuesday
+    &accelerationNone, // Wednesday
+    &accelerationNone, // Thursday
+    &accelerationNone, // Friday
+    &accelerationNone, // Saturday
+    &accelerationNone, // On/Off
+    &accelerationNone // Slot count
+};
+const AccelerationCurve *accelerationHeat[6] = {
+    &accelerationSmall, // degrees
+    &accelerationLarge, // percent
+    &accelerationSmall,
+    &accelerationLarge,
+    &accelerationSmall,
+    &accelerationLarge
+};
+const AccelerationCurve *accelerationTime[5] = {
+    &accelerationSmall, // Day
+    &accelerationSmall, // Month
+    &accelerationLarge, // Year
+    &accelerationSmall, // Hour
+    &accelerationLarge // Minute
+};
+
+/**
+ * inits one custom character for LCD. Max 8 custom characters :(
+ * returns true when all custom characters are created
+**/
+bool createCustomChar() {
+    byte *customChars[] = {chr_Clock, chr_First, chr_Second, chr_Faucet, chr_Calendar, chr_Drop, chr_Sunrise, chr_Sunset};
+
+    lcd.createChar(customCharLocation, customChars[customCharLocation]);
+    customCharLocation++;
+    return customCharLocation == sizeof(customChars) / sizeof(customChars[0]);
+}
+
+bool isIntervalSlot(const ScheduleSlot &slot) {
+    return slot.weekdays & slotInterval;
+}
+
+/**
+ * returns the first start of an interval slot
+**/
+time_t intervalAnchor(const ScheduleSlot &slot) {
+    return (time_t)slot.anchorDay * SECS_PER_DAY + slot.startHour * SECS_PER_HOUR + slot.startMinute * SECS_PER_MIN;
+}
+
+/**
+ * returns the latest start of an interval slot at or before t, 0 if none
+ * one division, however long ago the anchor is
+**/
+time_t intervalLastStart(const ScheduleSlot &slot, time_t t) {
+    time_t anchor = intervalAnchor(slot);
+    if (t < anchor) {
+        return 0;
+    }
+    return t - (t - anchor) % (slot.periodHours * SECS_PER_HOUR);
+}
+
+/**
+ * returns the minute of the day of a weekday slot, -1 without the sun times
+ * a sun slot uses the sunrise or sunset of today and stays within the day
+**/
+int16_t slotStartMinute(const ScheduleSlot &slot) {
+    int16_t offset = slot.startHour * 60 + slot.startMinute;
+    uint8_t base = slot.timeBase & ~baseBefore;
+    if (base == BASE_CLOCK) {
+        return offset;
+    }
+    if (!sun.isValid()) {
+        return -1;
+    }
+
+    int16_t minute = (base == BASE_SUNRISE) ? sun.getSunrise() : sun.getSunset();
+    if (slot.timeBase & baseBefore) {
+        minute -= offset;
+    } else {
+        minute += offset;
+    }
+    return constrain(minute, 0, WEEKSCHEDULE_MINUTES_PER_DAY - 1);
+}
+
+/**
+ * compiles the weekday slots of the enabled pumps into the sorted week of events
+ * and lists their interval slots
+ * runs when the settings are loaded or saved, so edits take effect with the save,
+ * and every day with the new sun times
+**/
+void compileSchedule() {
+    schedule.clear();
+    intervalCount = 0;
+    for (int i = 0; i < pumpCount; i++) {
+        if (isOn[i] != 1) {
+            continue;
+        }
+        for (uint8_t s = 0; s < slotCount[i]; s++) {
+            const ScheduleSlot &slot = slots[i][s];
+            if (slot.duration == 0) {
+                continue;
+            }
+            int16_t minute = slotStartMinute(slot);
+            if (isIntervalSlot(slot)) {
+                intervalRefs[intervalCount++] = i * slotMax + s;
+            } else if (minute >= 0) {
+                schedule.add(minute, slot.weekdays, i * slotMax + s);
+            }
+        }
+    }
+    schedule.sort();
+}
+
+/**
+ * computes the sunrise and sunset on the first evaluation of a day and keeps them
+ * the schedule is compiled again, the sun slots of the week move with the sun
+**/
+void updateSunTimes(time_t now) {
+    uint16_t day = elapsedDays(now);
+    if (day == sunDay) {
+        return;
+    }
+    sunDay = day;
+
+    tmElements_t newYear;
+    breakTime(now, newYear);
+    newYear.Month = 1;
+    newYear.Day = 1;
+    newYear.Hour = 0;
+    newYear.Minute = 0;
+    newYear.Second = 0;
+    sun.compute((now - makeTime(newYear)) / SECS_PER_DAY + 1);
+    compileSchedule();
+}
+
+/**
+ * returns the slot of the next start of the pump, 0 if it has none
+**/
+uint8_t nextSlot(int i) {
+    if (!clockValid) {
+        return 0;
+    }
+
+    unsigned long bestMinutes = 0xFFFFFFFF;
+    uint8_t best = 0;
+
+    // first start of the pump in the compiled week
+    uint8_t count = schedule.getCount();
+    uint16_t minute = WeekSchedule::minuteOfWeek(actualTime.Wday, actualTime.Hour, actualTime.Minute);
+    uint8_t e = schedule.lowerBound(minute);
+    for (uint8_t n = 0; n < count; n++) {
+        if (e >= count) {
+            e = 0; // next week
+        }
+        const WeekEvent &event = schedule.getEvent(e);
+        if (event.ref / slotMax == i) {
+            bestMinutes = (event.minute + WEEKSCHEDULE_MINUTES_PER_WEEK - minute) % WEEKSCHEDULE_MINUTES_PER_WEEK;
+            best = event.ref % slotMax;
+            break;
+        }
+        e++;
+    }
+
+    time_t now = makeTime(actualTime);
+    for (uint8_t r = 0; r < intervalCount; r++) {
+        if (intervalRefs[r] / slotMax != i) {
+            continue;
+        }
+        const ScheduleSlot &slot = slots[i][intervalRefs[r] % slotMax];
+        time_t last = intervalLastStart(slot, now);
+        time_t next = (last == 0) ? intervalAnchor(slot) : last + slot.periodHours * SECS_PER_HOUR;
+        if (now - last < SECS_PER_MIN) {
+            next = last; // starts in this minute
+        }
+        unsigned long minutes = (next - now) / SECS_PER_MIN;
+        if (minutes < bestMinutes) {
+            bestMinutes = minutes;
+            best = intervalRefs[r] % slotMax;
+        }
+    }
+    return best;
+}
+
+// settings before the slots: 11 bytes per pump, the high bytes of the durations follow the blocks
+const int durationHighEEPROMAddress = 22;
+// settings with slots are behind the old ones and marked by their version
+const int settingsVersionEEPROMAddress = 31;
+const uint8_t settingsVersion = 2;
+const int slotsEEPROMAddress = 32;
+// a pump takes 22 bytes: on/off, slot count and per slot weekdays, hour, minute and duration (2 bytes)
+const int pumpEEPROMSize = 2 + slotMax * 5;
+// interval of every slot behind the pumps: hours (1 byte) and anchor day (2 bytes)
+// only read for slots marked as interval slots, older settings have none
+const int intervalEEPROMAddress = slotsEEPROMAddress + 2 * pumpEEPROMSize;
+// time base of every slot behind the intervals (1 byte), erased EEPROM reads as clock time
+const int sunEEPROMAddress = intervalEEPROMAddress + 2 * slotMax * 3;
+// heat curve of the pumps behind the time bases, degrees and percent of every point (2 bytes)
+// erased EEPROM is not a valid curve and reads as heatCurveDefault
+const int heatEEPROMAddress = sunEEPROMAddress + 2 * slotMax;
+
+/**
+ * the points rise in temperature and are within the limits of the editor
+**/
+bool isValidHeatCurve(const HeatPoint *curve) {
+    for (uint8_t p = 0; p < heatPointCount; p++) {
+        if ((curve[p].celsius < heatCelsiusMin) || (curve[p].celsius > heatCelsiusMax)) { return false; }
+        if ((curve[p].percent < heatPercentMin) || (curve[p].percent > heatPercentMax)) { return false; }
+        if ((p > 0) && (curve[p].celsius <= curve[p - 1].celsius)) { return false; }
+    }
+    return true;
+}
+
+/**
+ * updates settings to EEPROM and compiles the schedule
+ * uses update function to save write cycles
 **/
-void createCustomChars() {
-    lcd.createChar(0, chr_Clock);
-    lcd.createChar(1, chr_First);
-    lcd.createChar(2, chr_Second);
-    lcd.createChar(3, chr_Faucet);
-    lcd.createChar(4, chr_Calendar);
-    lcd.createChar(5, chr_Drop);
+void updateEEPROMSettings() {
+    int addr = slotsEEPROMAddress;
+
+    // the edited interval slots start on the day of the save
+    time_t today = clockValid ? makeTime(actualTime) : 0;
+    for (int i = 0; i < pumpCount; i++) {
+        for (uint8_t s = 0; s < slotMax; s++) {
+            if (intervalEdited[i] & _BV(s)) {
+                slots[i][s].anchorDay = elapsedDays(today);
+            }
+        }
+        intervalEdited[i] = 0;
+    }
+
+    for (int i = 0; i < pumpCount; i++) {
+        EEPROM.update(addr, isOn[i]);
+        addr++;
+        EEPROM.update(addr, slotCount[i]);
+        addr++;
+        for (uint8_t s = 0; s < slotMax; s++) {
+            const ScheduleSlot &slot = slots[i][s];
+            EEPROM.update(addr, slot.weekdays);
+            addr++;
+            EEPROM.update(addr, slot.startHour);
+            addr++;
+            EEPROM.update(addr, slot.startMinute);
+            addr++;
+            EEPROM.put(addr, slot.duration);
+            addr += 2;
+        }
+    }
+
+    addr = intervalEEPROMAddress;
+    for (int i = 0; i < pumpCount; i++) {
+        for (uint8_t s = 0; s < slotMax; s++) {
+            EEPROM.update(addr, slots[i][s].periodHours);
+            addr++;
+            EEPROM.put(addr, slots[i][s].anchorDay);
+            addr += 2;
+        }
+    }
+
+    addr = sunEEPROMAddress;
+    for (int i = 0; i < pumpCount; i++) {
+        for (uint8_t s = 0; s < slotMax; s++) {
+            EEPROM.update(addr, slots[i][s].timeBase);
+            addr++;
+        }
+    }
+
+    addr = heatEEPROMAddress;
+    for (int i = 0; i < pumpCount; i++) {
+        for (uint8_t p = 0; p < heatPointCount; p++) {
+            EEPROM.update(addr, heatCurve[i][p].celsius);
+            addr++;
+            EEPROM.update(addr, heatCurve[i][p].percent);
+            addr++;
+        }
+    }
+    EEPROM.update(settingsVersionEEPROMAddress, settingsVersion);
+
+    compileSchedule();
 }
 
 /**
- * reads settings from EEPROM
+ * reads the settings from before the slots into the first slot of the pumps
  * if the values are not valid, 0 is applied
 **/
-void readEEPROMSettings() {
+void readLegacyEEPROMSettings() {
     int addr = 0;
 
     for (int i = 0; i < pumpCount; i++) {
-        startHour[i] = EEPROM.read(addr);
-        if (startHour[i] > 24) { startHour[i] = 0; }
+        ScheduleSlot &slot = slots[i][0];
+        slotCount[i] = 1;
+
+        slot.startHour = EEPROM.read(addr);
+        if (slot.startHour > 23) { slot.startHour = 0; }
         addr++;
 
-        startMinute[i] = EEPROM.read(addr);
-        if (startMinute[i] > 60) { startMinute[i] = 0; }
+        slot.startMinute = EEPROM.read(addr);
+        if (slot.startMinute > 59) { slot.startMinute = 0; }
         addr++;
 
-        duration[i] = EEPROM.read(addr);
-        if (duration[i] > 60) { duration[i] = 0; }
+        // high byte is behind the blocks of the pumps, erased EEPROM reads as 0
+        uint8_t durationHigh = EEPROM.read(durationHighEEPROMAddress + i);
+        if (durationHigh == 0xFF) { durationHigh = 0; }
+        slot.duration = (durationHigh << 8) | EEPROM.read(addr);
+        if (slot.duration > durationMax) { slot.duration = 0; }
         addr++;
 
         isOn[i] = EEPROM.read(addr);
-        if (isOn[i] > 2) { isOn[i] = 0; }
+        if (isOn[i] > 1) { isOn[i] = 0; }
         addr++;
 
+        slot.weekdays = 0;
         for (int j = 0; j < 7; j++) {
-            calendar[i][j] = EEPROM.read(addr);
-            if (calendar[i][j] > 2) { calendar[i][j] = 0; }
+            if (EEPROM.read(addr) == 1) {
+                slot.weekdays |= _BV(j);
+            }
             addr++;
         }
     }
 }
 
 /**
- * updates settings to EEPROM
- * uses update function to save write cycles
+ * reads settings from EEPROM and compiles the schedule
+ * settings from before the slots are converted once
+ * if the values are not valid, 0 is applied
 **/
-void updateEEPROMSettings() {
-    int addr = 0;
+void readEEPROMSettings() {
+    if (EEPROM.read(settingsVersionEEPROMAddress) != settingsVersion) {
+        readLegacyEEPROMSettings();
+        updateEEPROMSettings();
+        return;
+    }
+
+    int addr = slotsEEPROMAddress;
 
     for (int i = 0; i < pumpCount; i++) {
-        EEPROM.update(addr, startHour[i]);
-        addr++;
-        EEPROM.update(addr, startMinute[i]);
-        addr++;
-        EEPROM.update(addr, duration[i]);
+        isOn[i] = EEPROM.read(addr);
+        if (isOn[i] > 1) { isOn[i] = 0; }
         addr++;
-        EEPROM.update(addr, isOn[i]);
+
+        slotCount[i] = EEPROM.read(addr);
+        if ((slotCount[i] < 1) || (slotCount[i] > slotMax)) { slotCount[i] = 1; }
         addr++;
-        for (int j = 0; j < 7; j++) {
-            EEPROM.update(addr, calendar[i][j]);
+
+        for (uint8_t s = 0; s < slotMax; s++) {
+            ScheduleSlot &slot = slots[i][s];
+
+            slot.weekdays = EEPROM.read(addr);
+            addr++;
+
+            slot.startHour = EEPROM.read(addr);
+            if (slot.startHour > 23) { slot.startHour = 0; }
+            addr++;
+
+            slot.startMinute = EEPROM.read(addr);
+            if (slot.startMinute > 59) { slot.startMinute = 0; }
+            addr++;
+
+            EEPROM.get(addr, slot.duration);
+            if (slot.duration > durationMax) { slot.duration = 0; }
+            addr += 2;
+        }
+    }
+
+    addr = intervalEEPROMAddress;
+    for (int i = 0; i < pumpCount; i++) {
+        for (uint8_t s = 0; s < slotMax; s++) {
+            ScheduleSlot &slot = slots[i][s];
+
+            slot.periodHours = EEPROM.read(addr);
+            addr++;
+            EEPROM.get(addr, slot.anchorDay);
+            addr += 2;
+
+            if (!isIntervalSlot(slot)) {
+                continue;
+            }
+            if (slot.periodHours == 0) { slot.periodHours = 24; }
+            if (slot.anchorDay == 0xFFFF) { slot.anchorDay = 0; }
+        }
+    }
+
+    addr = sunEEPROMAddress;
+    for (int i = 0; i < pumpCount; i++) {
+        for (uint8_t s = 0; s < slotMax; s++) {
+            ScheduleSlot &slot = slots[i][s];
+
+            slot.timeBase = EEPROM.read(addr);
+            addr++;
+
+            if (((slot.timeBase & ~baseBefore) >= baseCount) || isIntervalSlot(slot)) { slot.timeBase = BASE_CLOCK; }
+            if ((slot.timeBase != BASE_CLOCK) && (slot.startHour > sunOffsetHoursMax)) { slot.startHour = sunOffsetHoursMax; }
+        }
+    }
+
+    addr = heatEEPROMAddress;
+    for (int i = 0; i < pumpCount; i++) {
+        for (uint8_t p = 0; p < heatPointCount; p++) {
+            heatCurve[i][p].celsius = EEPROM.read(addr);
+            addr++;
+            heatCurve[i][p].percent = EEPROM.read(addr);
             addr++;
         }
+        if (!isValidHeatCurve(heatCurve[i])) {
+            memcpy(heatCurve[i], heatCurveDefault, sizeof(heatCurveDefault));
+        }
     }
 
+    compileSchedule();
+}
+
+// incident log at the end of EEPROM, away from the settings:
+// watchdog reset count (2 bytes), reset cause and task of the last watchdog reset
+const int incidentEEPROMAddress = E2END - 3;
+
+/**
+ * reads the incident log and counts the watchdog reset, if this boot was one
+ * erased EEPROM reads 0xFFFF, so the count starts from 0
+**/
+void logIncident() {
+    EEPROM.get(incidentEEPROMAddress, watchdogResets);
+    if (watchdogResets == 0xFFFF) { watchdogResets = 0; }
+
+    if (watchdog.wasWatchdogReset()) {
+        watchdogResets++;
+        EEPROM.put(incidentEEPROMAddress, watchdogResets);
+        EEPROM.update(incidentEEPROMAddress + 2, watchdog.getResetCause());
+        EEPROM.update(incidentEEPROMAddress + 3, watchdog.getLastTask());
+    }
+    lastIncidentTask = EEPROM.read(incidentEEPROMAddress + 3);
 }
 
 /**
@@ -195,6 +786,81 @@ void saveTimeToRTC(tmElements_t newTm) {
     if (rtc.set(t) == 0) {
       // Serial.println("Time set!");
     }
+    // the jump of the clock is not a missed window
+    lastEvaluatedTime = 0;
+}
+
+// RAM of the RTC: time of the last schedule evaluation (4 bytes), the remaining
+// seconds of both pumps (2 bytes each) and a check byte
+// RAM registers are at every second address
+const uint8_t evaluationRAMAddress = DS1302_RAM_START;
+const uint8_t evaluationRAMCheck = 0xA5;
+
+/**
+ * milliseconds the pump still has to run, 0 when it is stopped
+ * a run waiting in dispatcher counts in full
+**/
+unsigned long pumpRemainingMillis(int i) {
+    if (!pumpActive[i]) {
+        return 0;
+    }
+    unsigned long remaining = pumpTimer.getRemainingMillis(i);
+    return (remaining > 0) ? remaining : runMillis[i];
+}
+
+/**
+ * keeps the time of the last schedule evaluation and the remaining runs in the RAM of the RTC
+ * it survives a power loss as long as the RTC runs from its battery
+**/
+void saveLastEvaluation(time_t t) {
+    uint8_t check = evaluationRAMCheck;
+    uint8_t data[8];
+
+    for (uint8_t b = 0; b < 4; b++) {
+        data[b] = t >> (8 * b);
+    }
+    for (int i = 0; i < 2; i++) {
+        unsigned long seconds = (pumpRemainingMillis(i) + 999) / 1000;
+        uint16_t remaining = (seconds > 0xFFFF) ? 0xFFFF : seconds;
+        data[4 + 2 * i] = remaining;
+        data[5 + 2 * i] = remaining >> 8;
+    }
+
+    rtc.writeEN(true);
+    for (uint8_t b = 0; b < 8; b++) {
+        rtc.writeRTC(evaluationRAMAddress + 2 * b, data[b]);
+        check ^= data[b];
+    }
+    rtc.writeRTC(evaluationRAMAddress + 16, check);
+    rtc.writeEN(false);
+    lastSavedEvaluation = t;
+}
+
+/**
+ * returns the time of the last schedule evaluation before the reset, 0 if unknown
+ * the remaining runs at that time are put into savedRemainingSeconds
+**/
+time_t loadLastEvaluation() {
+    uint8_t check = evaluationRAMCheck;
+    uint8_t data[8];
+
+    for (uint8_t b = 0; b < 8; b++) {
+        data[b] = rtc.readRTC(evaluationRAMAddress + 2 * b);
+        check ^= data[b];
+    }
+    if (rtc.readRTC(evaluationRAMAddress + 16) != check) {
+        return 0; // RTC lost its RAM
+    }
+
+    time_t t = 0;
+    for (uint8_t b = 0; b < 4; b++) {
+        t |= (time_t)data[b] << (8 * b);
+    }
+    for (int i = 0; i < 2; i++) {
+        savedRemainingSeconds[i] = data[4 + 2 * i] | ((uint16_t)data[5 + 2 * i] << 8);
+    }
+    lastSavedEvaluation = t;
+    return t;
 }
 
 /**
@@ -208,11 +874,11 @@ String to2digits(int number) {
 }
 
 /**
- * converts calendar array of 1 and 0 to custom character values
+ * converts weekday mask to custom character values
 **/
-void convertCalendar(int id) {
+void convertCalendar(uint8_t weekdays) {
     for (int i = 0; i < 7; i++) {
-        if (calendar[id][i] == 0) {
+        if (!(weekdays & _BV(i))) {
             convertedCalendar[i] = calendar_off[i];
         } else {
             convertedCalendar[i] = calendar_on[i];
@@ -231,72 +897,196 @@ char calendarDayForPrint(int id, int value) {
     }
 }
 
+/**
+ * prints duration in seconds as h:mm:ss
+**/
+void printDuration(uint16_t seconds) {
+    screen.print(seconds / 3600);
+    screen.print(":");
+    screen.print(to2digits((seconds / 60) % 60));
+    screen.print(":");
+    screen.print(to2digits(seconds % 60));
+}
+
+/**
+ * prints the start of the slot from column 2 of the first line:
+ * clock symbol and the time, or sun symbol and the offset like "-0:30"
+**/
+void printSlotStart(const ScheduleSlot &slot) {
+    uint8_t base = slot.timeBase & ~baseBefore;
+
+    screen.setCursor(2, 0);
+    if (base == BASE_CLOCK) {
+        screen.write(0); // clock symbol
+        screen.print(to2digits(slot.startHour));
+    } else {
+        screen.write(base == BASE_SUNRISE ? 6 : 7); // sunrise or sunset symbol
+        screen.print((slot.timeBase & baseBefore) ? "-" : "+");
+        screen.print(slot.startHour);
+    }
+    screen.print(":");
+    screen.print(to2digits(slot.startMinute));
+}
+
+/**
+ * prints the rule of the slot from column 2 of the second line:
+ * calendar symbol and weekdays, or "/" and the hours between the starts
+**/
+void printSlotRule(const ScheduleSlot &slot) {
+    screen.setCursor(2, 1);
+    if (isIntervalSlot(slot)) {
+        screen.print("/");
+        screen.print(slot.periodHours);
+        screen.print("h");
+        for (uint8_t n = String(slot.periodHours).length(); n < 6; n++) {
+            screen.print(" ");
+        }
+    } else {
+        convertCalendar(slot.weekdays);
+        screen.write(4); // calendar symbol
+        for (int i = 0; i < 7; i++) { // prints calendar
+            screen.print(convertedCalendar[i]);
+        }
+    }
+}
+
 /**
  * creates "pump" screen layout for LCD
+ * shows one slot: its number below the pump symbol, the number of slots at the end
 **/
-void printTimerValuesToLCD(int timerId) {
-    lcd.clear();
+void printTimerValuesToLCD(int timerId, uint8_t slotId) {
+    const ScheduleSlot &slot = slots[timerId][slotId];
 
-    convertCalendar(timerId);
+    screen.clear();
 
-    lcd.write(timerId + 1); // number 1 pump symbol
-    lcd.setCursor(2, 0);
-    lcd.write(0); // clock symbol
-    lcd.setCursor(3, 0);
-    lcd.print(to2digits(startHour[timerId]));
-    lcd.print(":");
-    lcd.print(to2digits(startMinute[timerId]));
-    lcd.setCursor(11, 0);
-    lcd.write(3); // faucet symbol
-    lcd.print(to2digits(duration[timerId]));
-    lcd.print("s");
+    screen.write(timerId + 1); // number 1 pump symbol
+    printSlotStart(slot);
+    screen.setCursor(8, 0);
+    screen.write(3); // faucet symbol
+    printDuration(slot.duration);
 
     // second line of lcd
-    lcd.setCursor(2, 1);
-    lcd.write(4); // calendar symbol
-    lcd.setCursor(3, 1);
-    for (int i = 0; i < 7; i++) { // prints calendar
-        lcd.print(convertedCalendar[i]);
-    }
-    lcd.setCursor(11, 1);
+    screen.setCursor(0, 1);
+    screen.print(slotId + 1);
+    printSlotRule(slot);
+    screen.setCursor(11, 1);
     if (isOn[timerId] == 1) { // prints enabled state of current pump
-        lcd.print("ON ");
+        screen.print("ON ");
     } else {
-        lcd.print("OFF");
+        screen.print("OFF");
     }
-
+    screen.setCursor(15, 1);
+    screen.print(slotCount[timerId]);
 }
 
 /**
  * creates time screen layout for LCD
 **/
 void printTimeToLCD() {
-    lcd.clear();
+    screen.clear();
+
+    if (!clockValid) {
+        screen.print("No clock");
+        return;
+    }
 
-    lcd.print(dayNames[actualTime.Wday - 1]);
-    lcd.setCursor(0, 1);
-    lcd.print(to2digits(actualTime.Day));
-    lcd.print(".");
-    lcd.print(to2digits(actualTime.Month));
-    lcd.print(".");
-    lcd.print(actualTime.Year + 1970); // must add 1970, because tm time is counted after 1970
+    screen.print(dayNames[actualTime.Wday - 1]);
+    screen.setCursor(0, 1);
+    screen.print(to2digits(actualTime.Day));
+    screen.print(".");
+    screen.print(to2digits(actualTime.Month));
+    screen.print(".");
+    screen.print(actualTime.Year + 1970); // must add 1970, because tm time is counted after 1970
+
+    screen.setCursor(11, 0);
+    screen.print(to2digits(actualTime.Hour));
+    screen.print(":");
+    screen.print(to2digits(actualTime.Minute));
+}
 
-    lcd.setCursor(11, 0);
-    lcd.print(to2digits(actualTime.Hour));
-    lcd.print(":");
-    lcd.print(to2digits(actualTime.Minute));
+/**
+ * shows a message for durationMillis instead of the cycling screens
+**/
+void showSplash(const char *line1, const char *line2, unsigned int durationMillis) {
+    screen.cursor_off();
+    screen.clear();
+    screen.print(line1);
+    screen.setCursor(0, 1);
+    screen.print(line2);
+
+    splashActive = true;
+    splashStartMillis = millis();
+    splashDuration = durationMillis;
 }
 
 /**
- * watches, if pumpActive, and turns on or off the relays
+ * switches the relays, when pumpActive changes
+ * a started pump waits in dispatcher until it fits into the power budget
+ * a started pump is stopped by pumpTimer after runMillis, even when the loop is busy
  * must be placed in loop()
 **/
 void pumpWatcher() {
+    static bool pumpRequested[2] = {false, false};
+    bool requested[2] = {false, false};
+    bool started[2] = {false, false};
+
     for (int i = 0; i < pumpCount; i++) {
-        if (pumpActive[i] == true) {
-            pump[i].startWater();
+        bool expired = pumpTimer.takeExpired(i);
+        bool filled = flow.takeTargetReached(i);
+        if (expired || filled) {
+            // relay was switched off by the timer or at the target volume
+            pumpActive[i] = false;
+            pumpRequested[i] = false;
+            dispatcher.release(i);
+            flow.endRun(i);
+            if (expired) {
+                pumpJitter.edge(i, pumpStopMillis[i]);
+            } else {
+                pumpTimer.cancel(i);
+                pumpJitter.cancel(i);
+            }
+            continue;
+        }
+        if (pumpRequested[i] == pumpActive[i]) {
+            continue;
+        }
+
+        pumpRequested[i] = pumpActive[i];
+        if (pumpActive[i]) {
+            dispatcher.request(i);
+            requested[i] = true;
         } else {
-            pump[i].stopWater();
+            // stopped before the end of the run, or while waiting
+            pumpTimer.cancel(i);
+            dispatcher.release(i);
+            flow.endRun(i);
+            relays.set(i, false);
+            pumpJitter.cancel(i);
+        }
+    }
+
+    uint8_t channel;
+    while ((channel = dispatcher.next(millis())) != PUMPDISPATCHER_NONE) {
+        relays.set(channel, true);
+        started[channel] = true;
+    }
+
+    // all changed relays are switched with one write of the output
+    relays.apply();
+
+    unsigned long now = millis();
+    for (int i = 0; i < pumpCount; i++) {
+        if (started[i]) {
+            pumpTimer.arm(i, runMillis[i]);
+            flow.startRun(i, targetMillilitres[i]);
+            if (!requested[i]) {
+                // delayed by the dispatcher on purpose, not a late start
+                pumpJitter.cancel(i);
+            }
+            if (pumpJitter.edge(i, now)) {
+                // scheduled start, the stop is measured against the run length
+                pumpJitter.expect(i, now + runMillis[i]);
+            }
         }
     }
 }
@@ -306,31 +1096,334 @@ void pumpWatcher() {
  * must be placed in loop()
 **/
 void timeWatcher() {
+    static unsigned long lastReadMillis = 0;
+    uint8_t lastSecond = actualTime.Second;
+    unsigned long readMillis = millis();
+
     if (!rtc.read(actualTime)) {
         // reads time and puts it in actualTime
+        if (actualTime.Second != lastSecond) {
+            secondStartMillis = lastReadMillis;
+        }
+        lastReadMillis = readMillis;
+        clockValid = true;
     } else {
-        lcd.clear();
-        lcd.print("RTC read error!");
-        delay(5000);
+        showSplash("RTC read error!", "", 5000);
     }
 }
 
 /**
- * prints "screen" to LCD. Like time screen or pump screen
- * defined by id
+ * prints degrees and percent of a point of the heat curve in its column
 **/
-void showEditScreen(int id) {
-    switch (id) {
-    case 0:
+void printHeatPoint(const HeatPoint *curve, uint8_t p) {
+    screen.setCursor(2 + 5 * p, 0);
+    if ((curve[p].celsius >= 0) && (curve[p].celsius < 10)) {
+        screen.print(" ");
+    }
+    screen.print(curve[p].celsius);
+    screen.print("C");
+
+    screen.setCursor(2 + 5 * p, 1);
+    if (curve[p].percent < 100) {
+        screen.print(" ");
+    }
+    screen.print(curve[p].percent);
+    screen.print("%");
+}
+
+/**
+ * creates heat curve screen layout for LCD
+ * degrees of the points in the first row, percent of the run length below
+**/
+void printHeatCurveToLCD(int i) {
+    screen.clear();
+    screen.write(i + 1); // pump symbol
+    for (uint8_t p = 0; p < heatPointCount; p++) {
+        printHeatPoint(heatCurve[i], p);
+    }
+}
+
+/**
+ * prints "screen" to LCD. Like time screen or pump screen
+ * defined by id
+**/
+void showEditScreen(int id) {
+    switch (id) {
+    case 0:
         printTimeToLCD();
         break;
 
     case 1:
-        printTimerValuesToLCD(0);
+    case 2:
+        // the edited slot, otherwise the one starting next
+        printTimerValuesToLCD(id - 1, isEditing ? editedSlot : nextSlot(id - 1));
+        break;
+
+    case menuHeat:
+    case menuHeat + 1:
+        printHeatCurveToLCD(id - menuHeat);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * prints upper bound of the percentile, the last bin of the monitor is open
+**/
+void printPercentile(const char *label, uint16_t value) {
+    screen.print(label);
+    if (value == JITTERMONITOR_OVERFLOW) {
+        screen.print(">1k");
+    } else {
+        screen.print("<");
+        screen.print(value);
+    }
+}
+
+/**
+ * creates schedule jitter screen layout for LCD
+ * min-max offset of the relay from the scheduled second in ms, missed events
+ * and percentiles
+**/
+void printJitterToLCD(int pumpId) {
+    screen.write(pumpId + 1); // pump symbol
+    screen.setCursor(2, 0);
+    screen.print(pumpJitter.getMinMillis(pumpId));
+    screen.print("-");
+    screen.print(pumpJitter.getMaxMillis(pumpId));
+    screen.print("ms m");
+    screen.print(pumpJitter.getMissed(pumpId));
+
+    screen.setCursor(0, 1);
+    printPercentile("p50", pumpJitter.getPercentileMillis(pumpId, 50));
+    printPercentile(" p90", pumpJitter.getPercentileMillis(pumpId, 90));
+}
+
+/**
+ * creates SRAM screen layout for LCD
+ * headroom is the SRAM never touched by the stack since boot
+**/
+void printMemoryToLCD() {
+    screen.print("Headroom ");
+    screen.print(memory.getStackHeadroom());
+    screen.print("B");
+    if (memory.isAlarm()) {
+        screen.print("!");
+    }
+
+    screen.setCursor(0, 1);
+    screen.print("Free ");
+    screen.print(memory.getFreeNow());
+    screen.print(" Blk ");
+    screen.print(memory.getLargestFreeBlock());
+}
+
+/**
+ * creates reset screen layout for LCD
+ * watchdog resets since the log was erased, task of the last one and cause of this boot
+**/
+void printResetsToLCD() {
+    screen.print("WDT ");
+    screen.print(watchdogResets);
+    screen.print(" Task ");
+    if (lastIncidentTask == WATCHDOG_NO_TASK) {
+        screen.print("-");
+    } else {
+        screen.print(lastIncidentTask);
+    }
+
+    // cause of this boot and time to the first schedule evaluation
+    screen.setCursor(0, 1);
+    screen.print("Boot ");
+    uint8_t cause = watchdog.getResetCause();
+    if (cause & _BV(WDRF)) {
+        screen.print("wdt ");
+    } else if (cause & _BV(BORF)) {
+        screen.print("bod ");
+    } else if (cause & _BV(EXTRF)) {
+        screen.print("ext ");
+    } else {
+        screen.print("pwr ");
+    }
+    if (!scheduleEvaluated) {
+        screen.print("-");
+    } else {
+        screen.print(firstEvaluationMillis);
+        screen.print("ms");
+    }
+}
+
+/**
+ * creates I2C screen layout for LCD
+ * failed transactions, bus recoveries and repeated initializations of the LCD
+**/
+void printI2CToLCD() {
+    screen.print("I2C err ");
+    screen.print(Twi.getErrorCount());
+    screen.print(" rec ");
+    screen.print(Twi.getRecoveries());
+
+    screen.setCursor(0, 1);
+    screen.print("LCD restarts ");
+    screen.print(lcdRestarts);
+}
+
+/**
+ * creates flow screen layout for LCD
+ * volume of the last run and all runs since boot, per pump
+**/
+void printFlowToLCD() {
+    for (int i = 0; i < pumpCount; i++) {
+        screen.setCursor(0, i);
+        screen.write(i + 1); // pump symbol
+        screen.print(" ");
+        screen.print(flow.getLastMillilitres(i));
+        screen.print("ml ");
+        screen.print(flow.getTotalMillilitres(i) / 1000);
+        screen.print("L");
+    }
+}
+
+/**
+ * creates soil moisture screen layout for LCD
+ * filtered moisture per pump, skipped and lengthened runs since boot
+**/
+void printMoistureToLCD() {
+    for (int i = 0; i < pumpCount; i++) {
+        screen.setCursor(0, i);
+        screen.write(i + 1); // pump symbol
+        screen.print(" ");
+        if (moisture.isValid(i)) {
+            screen.print(moisture.getPercent(i));
+            screen.print("%");
+        } else {
+            screen.print("-");
+        }
+        screen.setCursor(7, i);
+        screen.print("s");
+        screen.print(moistureSkips[i]);
+        screen.print(" e");
+        screen.print(moistureExtends[i]);
+    }
+}
+
+/**
+ * percent of the run length at the temperature in 1/16 degree, from heatCurve
+**/
+uint8_t heatPercent(int i, int16_t temperature) {
+    const HeatPoint *curve = heatCurve[i];
+
+    if (temperature <= curve[0].celsius * 16) {
+        return curve[0].percent;
+    }
+    for (uint8_t p = 1; p < heatPointCount; p++) {
+        int16_t high = curve[p].celsius * 16;
+        if (temperature < high) {
+            int16_t low = curve[p - 1].celsius * 16;
+            long span = (long)curve[p].percent - curve[p - 1].percent;
+            return curve[p - 1].percent + span * (temperature - low) / (high - low);
+        }
+    }
+    return curve[heatPointCount - 1].percent;
+}
+
+/**
+ * creates temperature screen layout for LCD
+ * last reading, failed readings and the scale of the run length per pump
+**/
+void printTemperatureToLCD() {
+    screen.print("Temp ");
+    if (thermometer.isValid()) {
+        int16_t tenths = thermometer.getTemperature() * 10 / 16;
+        if (tenths < 0) {
+            screen.print("-");
+            tenths = -tenths;
+        }
+        screen.print(tenths / 10);
+        screen.print(".");
+        screen.print(tenths % 10);
+        screen.print("C");
+    } else {
+        screen.print("-");
+    }
+    screen.print(" e");
+    screen.print(thermometer.getErrors());
+
+    screen.setCursor(0, 1);
+    for (int i = 0; i < pumpCount; i++) {
+        screen.write(i + 1); // pump symbol
+        screen.print(" ");
+        if (thermometer.isValid()) {
+            screen.print(heatPercent(i, thermometer.getTemperature()));
+            screen.print("% ");
+        } else {
+            screen.print("- ");
+        }
+    }
+}
+
+/**
+ * creates sun screen layout for LCD
+ * sunrise and sunset of today, as the sun slots use them
+**/
+void printSunToLCD() {
+    if (!sun.isValid()) {
+        screen.print("Sun -");
+        return;
+    }
+    screen.write(6); // sunrise symbol
+    screen.print(" ");
+    screen.print(to2digits(sun.getSunrise() / 60));
+    screen.print(":");
+    screen.print(to2digits(sun.getSunrise() % 60));
+    screen.setCursor(0, 1);
+    screen.write(7); // sunset symbol
+    screen.print(" ");
+    screen.print(to2digits(sun.getSunset() / 60));
+    screen.print(":");
+    screen.print(to2digits(sun.getSunset() % 60));
+}
+
+/**
+ * prints diagnostics page to LCD, redrawn by lcdCycler() to keep it current
+**/
+void showDiagnostics() {
+    screen.clear();
+
+    switch (diagnosticsPage) {
+    case 0:
+    case 1:
+        printJitterToLCD(diagnosticsPage);
         break;
 
     case 2:
-        printTimerValuesToLCD(1);
+        printMemoryToLCD();
+        break;
+
+    case 3:
+        printResetsToLCD();
+        break;
+
+    case 4:
+        printI2CToLCD();
+        break;
+
+    case 5:
+        printFlowToLCD();
+        break;
+
+    case 6:
+        printMoistureToLCD();
+        break;
+
+    case 7:
+        printTemperatureToLCD();
+        break;
+
+    case 8:
+        printSunToLCD();
         break;
 
     default:
@@ -342,6 +1435,21 @@ void showEditScreen(int id) {
  * cycling of the screens
 **/
 void lcdCycler() {
+    if (splashActive) {
+        if (millis() - splashStartMillis < splashDuration) {
+            return;
+        }
+        splashActive = false;
+        if (!isEditing) {
+            showEditScreen(cycler);
+        }
+    }
+
+    if (isDiagnostics) {
+        showDiagnostics();
+        return;
+    }
+
     if (!isEditing) {
         vDelay.start(vDelayDuration);
         if(vDelay.elapsed()) {
@@ -360,10 +1468,39 @@ void lcdCycler() {
 void lcdBacklightTick() {
     unsigned long currentMillis = millis();
 
+    if (!lcdReady) {
+        return;
+    }
+
     if (currentMillis - backlightPreviousMillis >= backlightDelayDuration) {
-        lcd.noBacklight();
+        if (lcd.getBacklight()) lcd.noBacklight();
     } else {
-        lcd.backlight();
+        if (!lcd.getBacklight()) lcd.backlight();
+    }
+}
+
+/**
+ * initializes the LCD step by step and then sends the changed parts of the frame
+ * never waits for the LCD, so it cannot delay the pumps
+ * when the I2C bus fails, frames are dropped until the LCD is initialized again
+**/
+void lcdTick() {
+    if (lcd.failed()) {
+        lcd.restart();
+        lcdReady = false;
+        customCharLocation = 0;
+        screen.invalidate();
+        lcdRestarts++;
+        return;
+    }
+    if (!lcdReady) {
+        if (lcd.beginStep()) {
+            lcdReady = createCustomChar(); // one per tick
+        }
+        return;
+    }
+    if (!lcd.busy()) {
+        screen.flush(lcdWritesPerTick);
     }
 }
 
@@ -371,22 +1508,34 @@ void lcdBacklightTick() {
  * shows configuration menu screen
 **/
 void menuScreen(int id) {
-    lcd.clear();
-    lcd.print("CONFIG MENU:");
-    lcd.setCursor(0, 1);
+    screen.clear();
+    screen.print("CONFIG MENU:");
+    screen.setCursor(0, 1);
     menuPosition = id;
 
     switch (id) {
     case 0:
-        lcd.print("Time and date");
+        screen.print("Time and date");
         break;
 
     case 1:
-        lcd.print("Pump #1");
+        screen.print("Pump #1");
         break;
 
     case 2:
-        lcd.print("Pump #2");
+        screen.print("Pump #2");
+        break;
+
+    case menuHeat:
+        screen.print("Heat curve #1");
+        break;
+
+    case menuHeat + 1:
+        screen.print("Heat curve #2");
+        break;
+
+    case menuDiagnostics:
+        screen.print("Diagnostics");
         break;
 
     default:
@@ -394,6 +1543,334 @@ void menuScreen(int id) {
     }
 }
 
+/**
+ * sets cursor to position defined by the editinPosition parameter
+**/
+void setCursorPosition() {
+    if (menuPosition == 0) {
+        screen.setCursor(cursorPositionTime[editingPosition][0], cursorPositionTime[editingPosition][1]);
+    } else if (menuPosition >= menuHeat) {
+        screen.setCursor(cursorPositionsHeat[editingPosition][0], cursorPositionsHeat[editingPosition][1]);
+    } else {
+       screen.setCursor(cursorPositionsPump[editingPosition][0], cursorPositionsPump[editingPosition][1]);
+    }
+}
+
+/**
+ * adds delta to the value of "value" parameter within the limits
+ * the value wraps around at the limits
+**/
+void encoderAddValue(int delta, uint8_t &value, int bottomLimit, int upperLimit) {
+    int range = upperLimit - bottomLimit + 1;
+    int offset = value - bottomLimit + delta; // int, because uint8_t cannot go to negative numbers
+
+    offset %= range;
+    if (offset < 0) offset += range;
+    value = bottomLimit + offset;
+};
+
+void encoderAddValue(int delta, int8_t &value, int bottomLimit, int upperLimit) {
+    int range = upperLimit - bottomLimit + 1;
+    int offset = value - bottomLimit + delta;
+
+    offset %= range;
+    if (offset < 0) offset += range;
+    value = bottomLimit + offset;
+};
+
+void encoderAddValue(int delta, uint16_t &value, long bottomLimit, long upperLimit) {
+    long range = upperLimit - bottomLimit + 1;
+    long offset = value - bottomLimit + delta;
+
+    offset %= range;
+    if (offset < 0) offset += range;
+    value = bottomLimit + offset;
+};
+
+/**
+ * moves the offset of a sun slot by delta hours, through -9 .. -0 and +0 .. +9
+**/
+void sunOffsetAddHours(int delta, ScheduleSlot &slot) {
+    // -9 is at 0, -0 at 9 and +0 at 10
+    uint8_t position = (slot.timeBase & baseBefore) ? sunOffsetHoursMax - slot.startHour : sunOffsetHoursMax + 1 + slot.startHour;
+
+    encoderAddValue(delta, position, 0, 2 * sunOffsetHoursMax + 1);
+    if (position <= sunOffsetHoursMax) {
+        slot.timeBase |= baseBefore;
+        slot.startHour = sunOffsetHoursMax - position;
+    } else {
+        slot.timeBase &= ~baseBefore;
+        slot.startHour = position - sunOffsetHoursMax - 1;
+    }
+}
+
+/**
+ * returns the step for the edited field from the rotation speed of the encoder
+ * acceleration is used only when the knob keeps turning in the same direction
+**/
+uint8_t accelerationStep(const AccelerationCurve &curve, RotaryEncoder::Direction direction) {
+    static RotaryEncoder::Direction lastDirection = RotaryEncoder::Direction::NOROTATION;
+    uint8_t step = 1;
+
+    if (direction == lastDirection) {
+        noInterrupts();
+        unsigned long millisBetween = encoder.getMillisBetweenRotations();
+        interrupts();
+        if (millisBetween < curve.fastMillis) {
+            step = curve.fastStep;
+        } else if (millisBetween < curve.mediumMillis) {
+            step = curve.mediumStep;
+        }
+    }
+    lastDirection = direction;
+    return step;
+}
+
+/**
+ * applies accumulated encoder steps to the edited field
+**/
+void applyEdit(int delta) {
+    if (menuPosition == 0) {
+        // set time and date
+        switch (editingPosition) {
+        case 0: // day
+            encoderAddValue(delta, newTime.Day, 1, 31);
+            break;
+
+        case 1: // month
+            encoderAddValue(delta, newTime.Month, 1, 12);
+            break;
+
+        case 2: // year
+            encoderAddValue(delta, newTime.Year, 0, 255);
+            break;
+
+        case 3: // hour
+            encoderAddValue(delta, newTime.Hour, 0, 23);
+            break;
+
+        case 4: // minute
+            encoderAddValue(delta, newTime.Minute, 0, 59);
+            break;
+
+        default:
+            break;
+        }
+    } else if (menuPosition >= menuHeat) {
+        // set heat curve, the degrees stay between the neighbouring points
+        HeatPoint *curve = heatCurve[menuPosition - menuHeat];
+        uint8_t p = editingPosition / 2;
+
+        if (editingPosition % 2 == 0) {
+            int low = (p > 0) ? curve[p - 1].celsius + 1 : heatCelsiusMin;
+            int high = (p < heatPointCount - 1) ? curve[p + 1].celsius - 1 : heatCelsiusMax;
+            encoderAddValue(delta, curve[p].celsius, low, high);
+        } else {
+            encoderAddValue(delta, curve[p].percent, heatPercentMin, heatPercentMax);
+        }
+    } else {
+        // set pumps
+        int pumpPosition = menuPosition - 1;
+        ScheduleSlot &slot = slots[pumpPosition][editedSlot];
+
+        switch (editingPosition) {
+        case 0: // slot
+            encoderAddValue(delta, editedSlot, 0, slotCount[pumpPosition] - 1);
+            break;
+
+        case 1: { // clock, sunrise or sunset, a new sun offset starts at +0:00
+            uint8_t base = slot.timeBase & ~baseBefore;
+            encoderAddValue(delta, base, 0, baseCount - 1);
+            if (base == BASE_CLOCK) {
+                slot.timeBase = BASE_CLOCK;
+            } else {
+                if (slot.timeBase == BASE_CLOCK) {
+                    slot.startHour = 0;
+                    slot.startMinute = 0;
+                }
+                slot.timeBase = (slot.timeBase & baseBefore) | base;
+            }
+            break;
+        }
+
+        case 2: // hours, or sign and hours of the sun offset
+            if (slot.timeBase != BASE_CLOCK) {
+                sunOffsetAddHours(delta, slot);
+            } else {
+                encoderAddValue(delta, slot.startHour, 0, 23);
+            }
+            intervalEdited[pumpPosition] |= _BV(editedSlot);
+            break;
+
+        case 3: // minutes
+            encoderAddValue(delta, slot.startMinute, 0, 59);
+            intervalEdited[pumpPosition] |= _BV(editedSlot);
+            break;
+
+        case 4: // duration
+            encoderAddValue(delta, slot.duration, 1, durationMax);
+            break;
+
+        case 5: // weekdays or interval, every step toggles, an interval starts at a clock time
+            if (delta % 2 != 0) {
+                slot.weekdays ^= slotInterval;
+                if (slot.periodHours == 0) {
+                    slot.periodHours = 24;
+                }
+                slot.timeBase = BASE_CLOCK;
+                intervalEdited[pumpPosition] |= _BV(editedSlot);
+            }
+            break;
+
+        case 6: // calendar, every step toggles the day, or hours of the interval
+            if (isIntervalSlot(slot)) {
+                encoderAddValue(delta, slot.periodHours, 1, 255);
+                intervalEdited[pumpPosition] |= _BV(editedSlot);
+                break;
+            }
+            // fall through
+        case 7:
+        case 8:
+        case 9:
+        case 10:
+        case 11:
+        case 12:
+            if (delta % 2 != 0) {
+                slot.weekdays ^= _BV(editingPosition - 6);
+            }
+            break;
+
+        case 13: // on/off
+            encoderAddValue(delta, isOn[pumpPosition], 0, 1);
+            break;
+
+        case 14: // slot count, the edited slot stays within
+            encoderAddValue(delta, slotCount[pumpPosition], 1, slotMax);
+            if (editedSlot >= slotCount[pumpPosition]) {
+                editedSlot = slotCount[pumpPosition] - 1;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+/**
+ * prints the edited field at the cursor and returns the cursor back to the field
+**/
+void printEditedField() {
+    if (menuPosition == 0) {
+        switch (editingPosition) {
+        case 0: // day
+            screen.print(to2digits(newTime.Day));
+            break;
+
+        case 1: // month
+            screen.print(to2digits(newTime.Month));
+            break;
+
+        case 2: // year
+            screen.print(to2digits(newTime.Year + 1970));
+            break;
+
+        case 3: // hour
+            screen.print(to2digits(newTime.Hour));
+            break;
+
+        case 4: // minute
+            screen.print(to2digits(newTime.Minute));
+            break;
+
+        default:
+            break;
+        }
+    } else if (menuPosition >= menuHeat) {
+        printHeatPoint(heatCurve[menuPosition - menuHeat], editingPosition / 2);
+    } else {
+        int pumpPosition = menuPosition - 1;
+        const ScheduleSlot &slot = slots[pumpPosition][editedSlot];
+
+        switch (editingPosition) {
+        case 0: // slot, the whole screen shows the other slot
+        case 14: // slot count, the edited slot may have changed
+            printTimerValuesToLCD(pumpPosition, editedSlot);
+            break;
+
+        case 1: // clock or sun
+        case 2: // hours, the sign of a sun offset may have changed
+            printSlotStart(slot);
+            break;
+
+        case 3: // minutes
+            screen.print(to2digits(slot.startMinute));
+            break;
+
+        case 4: // duration, printed from its first digit
+            screen.setCursor(9, 0);
+            printDuration(slot.duration);
+            break;
+
+        case 5: // weekdays or interval, the start may be a clock time again
+            printSlotStart(slot);
+            printSlotRule(slot);
+            break;
+
+        case 6: // calendar, or hours of the interval
+            if (isIntervalSlot(slot)) {
+                printSlotRule(slot);
+                break;
+            }
+            // fall through
+        case 7:
+        case 8:
+        case 9:
+        case 10:
+        case 11:
+        case 12:
+            screen.print(calendarDayForPrint(editingPosition - 6, slot.weekdays & _BV(editingPosition - 6)));
+            break;
+
+        case 13: // on/off
+            if (isOn[pumpPosition] == 1) {
+                screen.print("ON ");
+            } else {
+                screen.print("OFF");
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+    setCursorPosition();
+}
+
+/**
+ * applies the encoder steps collected since the last display frame
+ * and redraws the affected field or menu once
+ * runs once per display frame from the scheduler and
+ * must be called before the edited field or screen changes
+**/
+void applyPendingEdit() {
+    if (pendingEdit == 0) {
+        return;
+    }
+
+    if (isMenu) {
+        encoderAddValue(pendingEdit, menuPosition, 0, menuDiagnostics);
+        menuScreen(menuPosition);
+    } else if (isDiagnostics) {
+        encoderAddValue(pendingEdit, diagnosticsPage, 0, diagnosticsPageCount - 1);
+        showDiagnostics();
+    } else {
+        applyEdit(pendingEdit);
+        printEditedField();
+    }
+    pendingEdit = 0;
+}
+
 /**
  * handles longpress of the rotary encoder
  * used for entering to config menu and saving configuration
@@ -403,15 +1880,21 @@ void rotaryButtonLongPressHandler() {
         isEditing = true; // first command here
         // entering editing mode
         menuPosition = 0;
+        editedSlot = 0;
         isMenu = true;
         newTime = actualTime;
         menuScreen(menuPosition);
     } else {
         // exiting editing mode
-        lcd.clear();
-        lcd.cursor_off();
-        lcd.print("Saving config...");
-        delay(2000);
+        applyPendingEdit();
+        if (isDiagnostics) {
+            // nothing to save
+            isDiagnostics = false;
+            showEditScreen(cycler);
+            isEditing = false;
+            return;
+        }
+        showSplash("Saving config...", "", 2000);
         editingPosition = 0;
         calendarPosition = 0;
         if (menuPosition == 0) {
@@ -423,34 +1906,35 @@ void rotaryButtonLongPressHandler() {
     }
 }
 
-/**
- * sets cursor to position defined by the editinPosition parameter
-**/
-void setCursorPosition() {
-    if (menuPosition == 0) {
-        lcd.setCursor(cursorPositionTime[editingPosition][0], cursorPositionTime[editingPosition][1]);
-    } else {
-       lcd.setCursor(cursorPositionsPump[editingPosition][0], cursorPositionsPump[editingPosition][1]);
-    }
-}
-
 /**
  * handles click of the rotary encoder
 **/
 void rotaryButtonClickHandler() {
-    if (isEditing) {
+    if (isEditing && !isDiagnostics) {
+        applyPendingEdit();
         if (isMenu) {
             // click confirms menu
             isMenu = false;
+            if (menuPosition == menuDiagnostics) {
+                isDiagnostics = true;
+                diagnosticsPage = 0;
+                showDiagnostics();
+                return;
+            }
             showEditScreen(menuPosition);
-            lcd.cursor_on();
+            screen.cursor_on();
             setCursorPosition();
 
         } else {
             editingPosition++;
             if (menuPosition == 0) {
                if (editingPosition > cursorPositionTimeLength - 1) editingPosition = 0;
+            } else if (menuPosition >= menuHeat) {
+                if (editingPosition > cursorPositionsHeatLength - 1) editingPosition = 0;
             } else {
+                // an interval slot starts at a clock time and has its hours in place of the days
+                if ((editingPosition == 1) && isIntervalSlot(slots[menuPosition - 1][editedSlot])) editingPosition = 2;
+                if ((editingPosition == 7) && isIntervalSlot(slots[menuPosition - 1][editedSlot])) editingPosition = 13;
                 if (editingPosition > cursorPositionsPumpLength - 1) editingPosition = 0;
             }
             setCursorPosition();
@@ -458,170 +1942,579 @@ void rotaryButtonClickHandler() {
     }
 }
 
-/**
- * handles increasing and decreasing the value of "value" parameter within the limits
-**/
-void encoderAddValue(RotaryEncoder::Direction direction, uint8_t &value, int bottomLimit, int upperLimit) {
-    if (direction == RotaryEncoder::Direction::CLOCKWISE) {
-        value++;
-    } else if (direction == RotaryEncoder::Direction::COUNTERCLOCKWISE) {
-        if (value == bottomLimit) { // because of uint8_t cannot go to negative numbers
-            value = upperLimit;
-        } else {
-            value--;
-        }
-    }
-    if (value > upperLimit) value = bottomLimit;
-};
-
 /**
  * handles rotating of the rotary encoder
+ * only collects the steps, they are applied by applyPendingEdit()
 **/
 void rotaryEncoderTick() {
     static int pos = 0;
-    encoder.tick();
 
+    // encoder is ticked by the pin change interrupt
+    noInterrupts();
     int newPos = encoder.getPosition();
+    RotaryEncoder::Direction direction = encoder.getDirection();
+    interrupts();
 
     if (pos != newPos) {
-        RotaryEncoder::Direction direction = encoder.getDirection();
         backlightPreviousMillis = millis(); // when rotated, extend delay for backlight
 
         if (isEditing) {
-            if (isMenu) {
-                // user is in the main menu
-                encoderAddValue(direction, menuPosition, 0, 2);
-                menuScreen(menuPosition);
+            if (isMenu || isDiagnostics) {
+                // user is in the main menu or pages the diagnostics
+                pendingEdit += newPos - pos;
             } else {
+                uint8_t step;
                 if (menuPosition == 0) {
-                    // set time and date
-                    switch (editingPosition) {
-                    case 0: // day
-                        encoderAddValue(direction, newTime.Day, 1, 31);
-                        lcd.print(to2digits(newTime.Day));
-                        break;
-
-                    case 1: // month
-                        encoderAddValue(direction, newTime.Month, 1, 12);
-                        lcd.print(to2digits(newTime.Month));
-                        break;
-
-                    case 2: // year
-                        encoderAddValue(direction, newTime.Year, 0, 255);
-                        lcd.print(to2digits(newTime.Year + 1970));
-                        break;
-
-                    case 3: // hour
-                        encoderAddValue(direction, newTime.Hour, 0, 23);
-                        lcd.print(to2digits(newTime.Hour));
-                        break;
-
-                    case 4: // minute
-                        encoderAddValue(direction, newTime.Minute, 0, 59);
-                        lcd.print(to2digits(newTime.Minute));
-                        break;
-
-                    default:
-                        break;
-                    }
+                    step = accelerationStep(*accelerationTime[editingPosition], direction);
+                } else if (menuPosition >= menuHeat) {
+                    step = accelerationStep(*accelerationHeat[editingPosition], direction);
+                } else if ((editingPosition == 6) && isIntervalSlot(slots[menuPosition - 1][editedSlot])) {
+                    step = accelerationStep(accelerationInterval, direction);
                 } else {
-                    // set pumps
-                    int pumpPosition = menuPosition - 1;
-
-                    switch (editingPosition) {
-                    case 0: // hours
-                        encoderAddValue(direction, startHour[pumpPosition], 0, 23);
-                        lcd.print(to2digits(startHour[pumpPosition]));
-                        break;
-
-                    case 1: // minutes
-                        encoderAddValue(direction, startMinute[pumpPosition], 0, 59);
-                        lcd.print(to2digits(startMinute[pumpPosition]));
-                        break;
-
-                    case 2: // duration
-                        encoderAddValue(direction, duration[pumpPosition], 1, 59);
-                        lcd.print(to2digits(duration[pumpPosition]));
-                        break;
-
-                    case 3: // calendar
-                    case 4:
-                    case 5:
-                    case 6:
-                    case 7:
-                    case 8:
-                    case 9:
-                        encoderAddValue(direction, calendar[pumpPosition][editingPosition - 3], 0, 1);
-                        lcd.print(calendarDayForPrint(editingPosition - 3, calendar[pumpPosition][editingPosition - 3]));
-                        break;
-
-                    case 10: // on/off
-                        encoderAddValue(direction, isOn[pumpPosition], 0, 1);
-                        if (isOn[pumpPosition] == 1) {
-                            lcd.print("ON ");
-                        } else {
-                            lcd.print("OFF");
-                        }
-                        break;
-
-                    default:
-                        break;
-                    }
+                    step = accelerationStep(*accelerationPump[editingPosition], direction);
                 }
-                setCursorPosition();
+                pendingEdit += (newPos - pos) * step;
             }
         } // isEditing
         pos = newPos;
     }
 }
 
+/**
+ * handles the "water now" buttons
+ * click waters the pump for the duration of its first slot, long press stops it
+**/
+void waterNowHandler(uint8_t index, ButtonBank::Event event) {
+    backlightPreviousMillis = millis(); // when pressed, extend delay for backlight
+
+    if (event == ButtonBank::CLICK) {
+        runMillis[index] = slots[index][0].duration * 1000UL;
+        pumpActive[index] = true;
+    } else if (event == ButtonBank::LONG_PRESS_START) {
+        pumpActive[index] = false;
+    }
+}
+
+/**
+ * pin change interrupt of port D
+ * queues the transitions of the rotary button with a timestamp and counts the flow pulses
+**/
+ISR(PCINT2_vect) {
+    // the flow pulses of a run must not keep the backlight on and the controller awake
+    if (rotaryButton.captureEdge()) {
+        power.wakeUp();
+    }
+    flow.capture();
+}
+
+/**
+ * pin change interrupt of port C
+ * ticks the rotary encoder and wakes up on the "water now" buttons
+**/
+ISR(PCINT1_vect) {
+    encoder.tick();
+    power.wakeUp();
+}
+
+/**
+ * enables the pin change interrupt of the pin
+**/
+void enablePinChangeInterrupt(uint8_t pin) {
+    *digitalPinToPCMSK(pin) |= bit(digitalPinToPCMSKbit(pin));
+    *digitalPinToPCICR(pin) |= bit(digitalPinToPCICRbit(pin));
+}
+
+/**
+ * counts the scheduled starts, which pumpActivationWatcher() did not see
+ * e.g. because the RTC could not be read in that second
+ * inSlot is true, when the pump has a start in the current minute
+ * stops cannot be missed, they are made by pumpTimer
+**/
+void missedEventWatcher(int i, bool inSlot) {
+    if (!inSlot) {
+        scheduleSlotDone[i] = false;
+    } else if (!scheduleSlotDone[i] && (actualTime.Second > 0)) {
+        pumpJitter.miss(i); // start was not seen
+        scheduleSlotDone[i] = true;
+    }
+}
+
+/**
+ * returns the start of the latest watering window of the pump at or before t, 0 if none
+ * slotId is set to the slot of the window
+ * walks back from the binary search in the compiled week, at most once around it,
+ * interval slots take one division each
+**/
+time_t lastWindowStart(int i, time_t t, uint8_t &slotId) {
+    uint8_t count = schedule.getCount();
+    time_t minuteStart = t - t % SECS_PER_MIN;
+    uint16_t minute = WeekSchedule::minuteOfWeek(dayOfWeek(t), numberOfHours(t), numberOfMinutes(t));
+
+    time_t latest = 0;
+
+    uint8_t e = schedule.lowerBound(minute + 1); // first event after this minute
+    for (uint8_t n = 0; n < count; n++) {
+        e = (e == 0) ? count - 1 : e - 1;
+        const WeekEvent &event = schedule.getEvent(e);
+        if (event.ref / slotMax == i) {
+            long back = (long)minute - event.minute;
+            if (back < 0) {
+                back += WEEKSCHEDULE_MINUTES_PER_WEEK; // last week
+            }
+            slotId = event.ref % slotMax;
+            latest = minuteStart - back * SECS_PER_MIN;
+            break;
+        }
+    }
+
+    for (uint8_t r = 0; r < intervalCount; r++) {
+        if (intervalRefs[r] / slotMax != i) {
+            continue;
+        }
+        time_t start = intervalLastStart(slots[i][intervalRefs[r] % slotMax], t);
+        if (start > latest) {
+            latest = start;
+            slotId = intervalRefs[r] % slotMax;
+        }
+    }
+    return latest;
+}
+
+/**
+ * length of a scheduled run of the pump, adjusted to the soil moisture and the temperature
+ * returns 0 when the soil is wet enough to skip the run
+ * without a valid probe or temperature that part is left out
+**/
+unsigned long scheduledRunMillis(int i, unsigned long runMillis) {
+    if (moisture.isValid(i)) {
+        uint8_t percent = moisture.getPercent(i);
+        if (percent > moistureSkipAbove[i]) {
+            moistureSkips[i]++;
+            return 0;
+        }
+        if (percent < moistureExtendBelow[i]) {
+            moistureExtends[i]++;
+            runMillis = runMillis / 100 * moistureExtendPercent;
+        }
+    }
+
+    if (thermometer.isValid()) {
+        runMillis = runMillis / 100 * heatPercent(i, thermometer.getTemperature());
+    }
+    return runMillis;
+}
+
+/**
+ * starts the pump for the duration of the slot, pumpTimer stops it
+ * the soil moisture may skip or lengthen the run
+ * the matched second is seen on several evaluations, only the first one is handled,
+ * so a skip is counted once and a short run is not started again
+**/
+void startScheduledRun(int i, uint8_t slotId) {
+    if (scheduleSlotDone[i]) {
+        return;
+    }
+
+    unsigned long run = pumpActive[i] ? 0 : scheduledRunMillis(i, slots[i][slotId].duration * 1000UL);
+    if (run > 0) {
+        pumpJitter.expect(i, secondStartMillis);
+        runMillis[i] = run;
+        pumpActive[i] = true;
+    }
+    scheduleSlotDone[i] = true;
+}
+
+/**
+ * the schedule was not evaluated from "from" to "to", because of a power loss (atBoot)
+ * or a stall. Only the latest window of every pump is looked at, so it takes bounded time
+ * a window started in the gap is caught up by the policy, with the run scaled like at its start
+ * a run cut by the power loss is caught up from its remaining time saved with "from",
+ * so the scaling and the waiting in dispatcher of the run are kept
+ * pumps running during a stall are stopped by pumpTimer anyway
+**/
+void catchUpMissedWindows(time_t from, time_t to, bool atBoot) {
+    for (int i = 0; i < pumpCount; i++) {
+        if ((isOn[i] != 1) || pumpActive[i]) {
+            continue;
+        }
+        uint8_t slotId = 0;
+        time_t start = lastWindowStart(i, to, slotId);
+
+        unsigned long fullRun = 0;
+        time_t end = 0;
+        if ((start > from) && (to - start <= catchUpMaxAge)) {
+            fullRun = scheduledRunMillis(i, slots[i][slotId].duration * 1000UL);
+            end = start + fullRun / 1000;
+        } else if (atBoot && (savedRemainingSeconds[i] > 0) && (to - from <= catchUpMaxAge)) {
+            fullRun = savedRemainingSeconds[i] * 1000UL;
+            end = from + savedRemainingSeconds[i];
+        }
+
+        unsigned long run = 0;
+        if ((catchUpPolicy == CATCHUP_REMAINING) && (to < end)) {
+            run = (end - to) * 1000UL;
+        } else if (catchUpPolicy == CATCHUP_FULL) {
+            run = fullRun;
+        }
+        if (run > 0) {
+            runMillis[i] = run;
+            pumpActive[i] = true;
+        }
+    }
+}
+
 /**
  * watches the activation time and activates the pumps
+ * the relay edge is expected from the start of the matched second, see pumpWatcher()
+ * gaps between the evaluations are caught up, see catchUpMissedWindows()
 **/
 void pumpActivationWatcher() {
+    if (!clockValid) {
+        return; // Wday is 0 until the first read
+    }
+
+    // after a watchdog reset a run cut by the reset is not resumed, see logIncident()
+    // the gap of the reset is handled like a stall, starts missed in it are caught up
+    time_t now = makeTime(actualTime);
+    updateSunTimes(now);
+    bool atBoot = !scheduleEvaluated && !watchdog.wasWatchdogReset();
+    if ((lastEvaluatedTime != 0) && (now >= lastEvaluatedTime) && (atBoot || (now > lastEvaluatedTime + 1))) {
+        catchUpMissedWindows(lastEvaluatedTime, now, atBoot);
+    }
+    lastEvaluatedTime = now;
+
+    if (!scheduleEvaluated) {
+        scheduleEvaluated = true;
+        firstEvaluationMillis = millis();
+    }
+
+    // starts in the current minute, found by a binary search in the compiled week
+    bool inSlot[2] = {false, false};
+    uint16_t minute = WeekSchedule::minuteOfWeek(actualTime.Wday, actualTime.Hour, actualTime.Minute);
+    for (uint8_t e = schedule.lowerBound(minute); e < schedule.getCount(); e++) {
+        const WeekEvent &event = schedule.getEvent(e);
+        if (event.minute != minute) {
+            break;
+        }
+        int i = event.ref / slotMax;
+        inSlot[i] = true;
+        if (actualTime.Second == 0) { // time is matched
+            startScheduledRun(i, event.ref % slotMax);
+        }
+    }
+
+    // interval slots are evaluated arithmetically, their starts are on a full minute
+    for (uint8_t r = 0; r < intervalCount; r++) {
+        int i = intervalRefs[r] / slotMax;
+        time_t start = intervalLastStart(slots[i][intervalRefs[r] % slotMax], now);
+        if ((start == 0) || (now - start >= SECS_PER_MIN)) {
+            continue;
+        }
+        inSlot[i] = true;
+        if (now == start) {
+            startScheduledRun(i, intervalRefs[r] % slotMax);
+        }
+    }
+
     for (int i = 0; i < pumpCount; i++) {
-        if (isOn[i] == 1) {
-            if (calendar[i][actualTime.Wday - 1] == 1) { // weekday is matched. -1 because Wday is from 1, not 0
-                if ((actualTime.Hour == startHour[i]) && (actualTime.Minute == startMinute[i]) && (actualTime.Second == 0)) { // time is matched
-                    // start the pump
-                    pumpActive[i] = true;
-                } else if ((actualTime.Hour == startHour[i]) && (actualTime.Minute == startMinute[i]) && (actualTime.Second == duration[i])) {
-                    // stops the pump
-                    pumpActive[i] = false;
-                }
-            }
+        missedEventWatcher(i, inSlot[i]);
+    }
+
+    // every second while a pump runs and once after it stopped,
+    // so the remaining time of a cut run is known after a power loss
+    static bool wasRunning = false;
+    bool running = false;
+    for (int i = 0; i < pumpCount; i++) {
+        running = running || pumpActive[i];
+    }
+    if ((now != lastSavedEvaluation) && (running || wasRunning || (now / SECS_PER_MIN != lastSavedEvaluation / SECS_PER_MIN))) {
+        saveLastEvaluation(now);
+        wasRunning = running;
+    }
+}
+
+/**
+ * scans the stack canary and warns when the SRAM headroom gets low
+**/
+void memoryWatcher() {
+    bool alarm = memory.isAlarm();
+
+    memory.update();
+    if (memory.isAlarm() && !alarm) {
+        showSplash("Low memory!", "", 5000);
+    }
+}
+
+/**
+ * powers and samples the moisture probes in short windows
+**/
+void moistureTick() {
+    moisture.tick();
+}
+
+/**
+ * starts a temperature conversion, or reads it when it is done
+**/
+void thermometerTick() {
+    thermometer.tick();
+}
+
+/**
+ * ticks the rotary button
+**/
+void rotaryButtonTick() {
+    rotaryButton.tick();
+}
+
+/**
+ * ticks the "water now" buttons
+**/
+void waterNowButtonsTick() {
+    waterNowButtons.tick();
+}
+
+// ============================== TASKS ========================================
+
+#ifdef PLANTPUMPER_PROFILE
+// profiling build: task runtimes are sent as CSV frame to Serial
+const unsigned long profileFrameInterval = 10000;
+unsigned long profileFrameMillis = 0;
+// part of the frame being sent, 0 when waiting for the next frame
+uint8_t profileSection = 0;
+// a part of the frame is at most this long, it is only sent when it fits into the Serial buffer
+const int profilePartBytes = 60;
+
+void profileTick();
+#endif
+
+// tasks in priority order with their period and low power period in milliseconds
+CoopTask tasks[] = {
+    {rotaryEncoderTick, 5, 50},
+    {rotaryButtonTick, 5, 50}, // button edges are queued with their time, polling late is fine
+    {waterNowButtonsTick, 10, 50},
+    {timeWatcher, 250}, // every second is read several times, so Second == 0 is never skipped
+    {pumpActivationWatcher, 250},
+    {pumpWatcher, 10, 250},
+    {applyPendingEdit, 40, 500}, // display frame of the editor
+    {lcdCycler, 50, 500},
+    {lcdTick, 2, 100},
+    {lcdBacklightTick, 100},
+    {memoryWatcher, 1000, 10000},
+    {moistureTick, 50, 250}, // the probes are powered from one tick to the next
+    {thermometerTick, 50, 250}
+#ifdef PLANTPUMPER_PROFILE
+    , {profileTick, 20}
+#endif
+};
+CoopScheduler scheduler(tasks, sizeof(tasks) / sizeof(tasks[0]));
+
+#ifdef PLANTPUMPER_PROFILE
+// same order as tasks[], the last entry is the whole scheduler pass
+const char profileName0[] PROGMEM = "rotaryEncoderTick";
+const char profileName1[] PROGMEM = "rotaryButtonTick";
+const char profileName2[] PROGMEM = "waterNowButtonsTick";
+const char profileName3[] PROGMEM = "timeWatcher";
+const char profileName4[] PROGMEM = "pumpActivationWatcher";
+const char profileName5[] PROGMEM = "pumpWatcher";
+const char profileName6[] PROGMEM = "applyPendingEdit";
+const char profileName7[] PROGMEM = "lcdCycler";
+const char profileName8[] PROGMEM = "lcdTick";
+const char profileName9[] PROGMEM = "lcdBacklightTick";
+const char profileName10[] PROGMEM = "memoryWatcher";
+const char profileName11[] PROGMEM = "moistureTick";
+const char profileName12[] PROGMEM = "thermometerTick";
+const char profileName13[] PROGMEM = "profileTick";
+const char profileName14[] PROGMEM = "pass";
+const char * const profileNames[] PROGMEM = {
+    profileName0, profileName1, profileName2, profileName3, profileName4,
+    profileName5, profileName6, profileName7, profileName8, profileName9,
+    profileName10, profileName11, profileName12, profileName13, profileName14
+};
+
+TaskProfile profiles[sizeof(tasks) / sizeof(tasks[0]) + 1];
+TaskProfiler profiler(profiles, sizeof(profiles) / sizeof(profiles[0]));
+
+void profileHook(uint8_t index, unsigned long runtimeMicros) {
+    profiler.record(index, runtimeMicros);
+}
+
+// cost of a wake up without a due task: interrupt, sleep entry and the scheduler pass
+const uint16_t profileWakeupMicros = 20;
+
+/**
+ * expected duty cycle of the current power mode
+ * from the task periods and the average runtimes of the frame, see DutyCycleModel.h
+**/
+uint16_t profileExpectedDuty() {
+    const uint8_t count = sizeof(tasks) / sizeof(tasks[0]);
+    DutyCycleTask model[count];
+    bool lowPower = scheduler.isLowPower();
+
+    for (uint8_t i = 0; i < count; i++) {
+        model[i].periodMillis = (lowPower && tasks[i].lowPowerPeriodMillis) ? tasks[i].lowPowerPeriodMillis : tasks[i].periodMillis;
+        model[i].runtimeMicros = profiles[i].count ? profiles[i].sumMicros / profiles[i].count : 0;
+    }
+    // 8.192 ms Timer2 tick in deep sleep, 1.024 ms Timer0 tick otherwise
+    return expectedDutyPermille(model, count, lowPower ? 122 : 977, profileWakeupMicros);
+}
+
+/**
+ * sends one part of the frame per run, only when it fits into the Serial buffer,
+ * so printing never waits for the transmission and blocks the loop
+**/
+void profileTick() {
+    if (Serial.availableForWrite() < profilePartBytes) {
+        return;
+    }
+
+    switch (profileSection) {
+    case 0:
+        if (millis() - profileFrameMillis >= profileFrameInterval) {
+            profileFrameMillis = millis();
+            profileSection = 1;
+            Serial.print(F("# first evaluation ms="));
+            Serial.println(firstEvaluationMillis);
+        }
+        break;
+
+    case 1: // duty cycle, before the task runtimes are reset
+        if (power.printCsvLine(Serial, profileExpectedDuty())) {
+            profileSection++;
+        }
+        break;
+
+    case 2: // task runtimes
+        if (profiler.printCsvLine(Serial, profileNames)) {
+            profileSection++;
+        }
+        break;
+
+    case 3: // schedule jitter
+        if (pumpJitter.printCsvLine(Serial)) {
+            profileSection++;
+        }
+        break;
+
+    case 4: // SRAM
+        if (memory.printCsvLine(Serial)) {
+            profileSection++;
         }
+        break;
+
+    case 5: // run volumes
+        if (flow.printCsvLine(Serial)) {
+            profileSection++;
+        }
+        break;
+
+    case 6: // worst runtimes and deadline misses of the tasks
+        if (scheduler.printCsvLine(Serial, profileNames)) {
+            profileSection = 0;
+        }
+        break;
+
+    default:
+        profileSection = 0;
+        break;
     }
 }
+#endif
 
 // ============================== SETUP & LOOP =================================
 
+/**
+ * boots in stages, the schedule is evaluated as early as possible:
+ * 1. relays are off since the constructors, or with relays.begin() on the I2C bus
+ * 2. settings and clock are loaded and the schedule is evaluated, missed windows are caught up
+ * 3. inputs, power management and the scheduler are started
+ * 4. the LCD is initialized in the background by lcdTick(), about 1.1 s
+**/
 void setup() {
     // Serial.begin(9600);
 
-    // inits LCD
-    lcd.begin();
-    lcd.backlight();
-    createCustomChars();
-    lcd.home();
-    lcd.print("PlantPumper v2");
-    lcd.setCursor(0, 1);
-    lcd.print("booting up...");
+    relays.begin();
+
+    // count a hang before anything else
+    logIncident();
+
+    readEEPROMSettings();
+    lastEvaluatedTime = loadLastEvaluation();
+    timeWatcher();
+    pumpActivationWatcher();
+
+    // the boot screen waits in the frame for the LCD
+    if (!splashActive) {
+        screen.print("PlantPumper v2");
+        screen.setCursor(0, 1);
+        screen.print("booting up...");
+    }
 
     // inits rotary encoder
     rotaryButton.attachClick(rotaryButtonClickHandler);
     rotaryButton.attachLongPressStop(rotaryButtonLongPressHandler);
+    encoder.begin();
+    enablePinChangeInterrupt(ROTARYENCODER_BUTTON);
+    enablePinChangeInterrupt(ROTARYENCODER_PIN1);
+    enablePinChangeInterrupt(ROTARYENCODER_PIN2);
+
+    // counts the pulses of the flow sensor
+    flow.begin();
+    enablePinChangeInterrupt(FLOW_SENSOR);
+
+    // inits "water now" buttons, index of the button is the pump
+    waterNowButtons.addButton(WATERNOW_BUTTON1);
+    waterNowButtons.addButton(WATERNOW_BUTTON2);
+    waterNowButtons.attachEvent(waterNowHandler);
+    enablePinChangeInterrupt(WATERNOW_BUTTON1);
+    enablePinChangeInterrupt(WATERNOW_BUTTON2);
+
+    if (watchdog.wasWatchdogReset()) {
+        showSplash("Watchdog reset!", "Pumps stopped", 5000);
+    }
 
-    // load settings from EEPROM
-    readEEPROMSettings();
+    for (int i = 0; i < pumpCount; i++) {
+        dispatcher.setWeight(i, pumpWeight[i]);
+        dispatcher.setPriority(i, pumpPriority[i]);
+    }
+
+    power.begin();
+    pumpTimer.begin();
+    // the ADC is switched on only for the measurement windows
+    moisture.setCalibration(moistureDryRaw, moistureWetRaw);
+    moisture.begin(60000, 100);
+    thermometer.begin(30000);
+#ifdef PLANTPUMPER_PROFILE
+    Serial.begin(115200);
+    scheduler.attachRunHook(profileHook);
+#endif
+    scheduler.setBreadcrumb(watchdog.getBreadcrumb());
+    scheduler.begin();
+    watchdog.begin(WDTO_1S);
+}
+
+/**
+ * nothing to do until the next scheduled start or an input
+ * backlight is off, nobody edits and no pump runs
+**/
+bool isControllerIdle() {
+    if (isEditing || splashActive || (millis() - backlightPreviousMillis < backlightDelayDuration)) {
+        return false;
+    }
+    for (int i = 0; i < pumpCount; i++) {
+        if (pumpActive[i]) {
+            return false;
+        }
+    }
+    return true;
 }
 
 void loop() {
-    timeWatcher();
-    pumpWatcher();
-    rotaryButton.tick();
-    rotaryEncoderTick();
-    lcdBacklightTick();
-    lcdCycler();
-    pumpActivationWatcher();
+    scheduler.run();
+    watchdog.feed();
+
+    if (power.takeWakeUp()) {
+        backlightPreviousMillis = millis(); // any input extends delay for backlight
+    }
+    scheduler.setLowPower(isControllerIdle());
+    power.sleep(scheduler.millisUntilNextTask(), scheduler.isLowPower());
 }
\ No newline at end of file
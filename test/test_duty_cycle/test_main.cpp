@@ -0,0 +1,66 @@
+// -----
+// test_main.cpp - Host test of DutyCycleModel.h
+// -----
+// 19.10.2026 created
+// -----
+
+#include <unity.h>
+#include <DutyCycleModel.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// only the wake ups of the 8.192 ms Timer2 tick, 122 * 20 us
+void test_wakeups_only(void)
+{
+  TEST_ASSERT_EQUAL_UINT16(2, expectedDutyPermille(NULL, 0, 122, 20));
+}
+
+// 4 ms every 250 ms is 16 ms per second, plus the wake ups
+void test_periodic_task(void)
+{
+  DutyCycleTask tasks[] = {{250, 4000}};
+  TEST_ASSERT_EQUAL_UINT16(18, expectedDutyPermille(tasks, 1, 122, 20));
+}
+
+// a task with period 0 runs on every wake up
+void test_task_on_every_wakeup(void)
+{
+  DutyCycleTask tasks[] = {{0, 10}, {1000, 5000}};
+  TEST_ASSERT_EQUAL_UINT16(34, expectedDutyPermille(tasks, 2, 977, 20));
+}
+
+// more work than fits into a second stays at 1000
+void test_saturation(void)
+{
+  DutyCycleTask tasks[] = {{0, 2000}};
+  TEST_ASSERT_EQUAL_UINT16(1000, expectedDutyPermille(tasks, 1, 977, 20));
+}
+
+// the task table of the firmware in low power mode, compared with the
+// same sum in floating point
+void test_against_float(void)
+{
+  DutyCycleTask tasks[] = {
+    {50, 40}, {50, 30}, {50, 60}, {250, 900}, {250, 1200}, {250, 80},
+    {500, 30}, {500, 50}, {100, 40}, {100, 20}, {10000, 300}, {250, 2000}, {250, 7000}
+  };
+  uint8_t count = sizeof(tasks) / sizeof(tasks[0]);
+
+  double awake = 122 * 20.0;
+  for (uint8_t i = 0; i < count; i++) {
+    awake += tasks[i].runtimeMicros * 1000.0 / tasks[i].periodMillis;
+  }
+  TEST_ASSERT_UINT16_WITHIN(1, (uint16_t)(awake / 1000), expectedDutyPermille(tasks, count, 122, 20));
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_wakeups_only);
+  RUN_TEST(test_periodic_task);
+  RUN_TEST(test_task_on_every_wakeup);
+  RUN_TEST(test_saturation);
+  RUN_TEST(test_against_float);
+  return UNITY_END();
+}
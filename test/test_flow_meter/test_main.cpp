@@ -0,0 +1,117 @@
+// -----
+// test_main.cpp - Host test of FlowModel.h
+// -----
+// 19.10.2026 created
+// -----
+
+#include <unity.h>
+#include <FlowModel.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// the YF-S201 calibration of the firmware
+#define PULSES_PER_LITRE 450
+
+// levels as seen by the shared pin change interrupt: other pins repeat the
+// current level, only the rising edges are pulses.
+void test_pulse_counting(void)
+{
+  const bool levels[] = {true, true, false, false, true, false, true, true, true, false, true};
+  bool previous = true; // idle level of the open collector with pull-up
+  uint8_t pulses = 0;
+
+  for (uint8_t i = 0; i < sizeof(levels); i++) {
+    if (flowIsPulse(previous, levels[i])) {
+      pulses++;
+    }
+    previous = levels[i];
+  }
+  TEST_ASSERT_EQUAL_UINT8(3, pulses);
+}
+
+void test_to_millilitres(void)
+{
+  TEST_ASSERT_EQUAL_UINT32(0, flowToMillilitres(0, PULSES_PER_LITRE));
+  TEST_ASSERT_EQUAL_UINT32(2, flowToMillilitres(1, PULSES_PER_LITRE));
+  TEST_ASSERT_EQUAL_UINT32(500, flowToMillilitres(225, PULSES_PER_LITRE));
+  TEST_ASSERT_EQUAL_UINT32(1000, flowToMillilitres(450, PULSES_PER_LITRE));
+  TEST_ASSERT_EQUAL_UINT32(2002, flowToMillilitres(901, PULSES_PER_LITRE));
+}
+
+// the split arithmetic must not overflow where pulses * 1000 would
+void test_to_millilitres_large(void)
+{
+  uint32_t pulses = 4000000000UL;
+  uint64_t expected = (uint64_t)pulses * 1000 / PULSES_PER_LITRE;
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)expected, flowToMillilitres(pulses, PULSES_PER_LITRE));
+}
+
+void test_to_pulses(void)
+{
+  TEST_ASSERT_EQUAL_UINT32(0, flowToPulses(0, PULSES_PER_LITRE));
+  TEST_ASSERT_EQUAL_UINT32(112, flowToPulses(250, PULSES_PER_LITRE));
+  TEST_ASSERT_EQUAL_UINT32(450, flowToPulses(1000, PULSES_PER_LITRE));
+  TEST_ASSERT_EQUAL_UINT32(45000, flowToPulses(100000, PULSES_PER_LITRE));
+}
+
+// volume to pulses and back loses less than one pulse
+void test_round_trip(void)
+{
+  for (uint32_t ml = 0; ml < 20000; ml += 7) {
+    uint32_t back = flowToMillilitres(flowToPulses(ml, PULSES_PER_LITRE), PULSES_PER_LITRE);
+    TEST_ASSERT_TRUE(back <= ml);
+    TEST_ASSERT_TRUE(ml - back <= 1000 / PULSES_PER_LITRE + 1);
+  }
+}
+
+void test_target_pulses(void)
+{
+  TEST_ASSERT_EQUAL_UINT32(0, flowTargetPulses(0, PULSES_PER_LITRE));
+  TEST_ASSERT_EQUAL_UINT32(1, flowTargetPulses(1, PULSES_PER_LITRE)); // below one pulse
+  TEST_ASSERT_EQUAL_UINT32(225, flowTargetPulses(500, PULSES_PER_LITRE));
+}
+
+// counts the pulses of a run until the target stops it
+void test_target_stop(void)
+{
+  uint32_t start = 1234;
+  uint32_t target = flowTargetPulses(500, PULSES_PER_LITRE);
+  uint32_t pulses = start;
+
+  while (!flowTargetReached(pulses, start, target)) {
+    pulses++;
+    TEST_ASSERT_TRUE(pulses - start <= target);
+  }
+  TEST_ASSERT_EQUAL_UINT32(225, pulses - start);
+  TEST_ASSERT_EQUAL_UINT32(500, flowToMillilitres(pulses - start, PULSES_PER_LITRE));
+}
+
+void test_no_target_never_stops(void)
+{
+  TEST_ASSERT_FALSE(flowTargetReached(100000, 0, 0));
+}
+
+// the pulse counter overflows during the run
+void test_target_across_overflow(void)
+{
+  uint32_t start = 0xFFFFFFF0UL;
+  TEST_ASSERT_FALSE(flowTargetReached(0xFFFFFFFFUL, start, 100));
+  TEST_ASSERT_FALSE(flowTargetReached(0x53, start, 100));
+  TEST_ASSERT_TRUE(flowTargetReached(0x54, start, 100));
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_pulse_counting);
+  RUN_TEST(test_to_millilitres);
+  RUN_TEST(test_to_millilitres_large);
+  RUN_TEST(test_to_pulses);
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_target_pulses);
+  RUN_TEST(test_target_stop);
+  RUN_TEST(test_no_target_never_stops);
+  RUN_TEST(test_target_across_overflow);
+  return UNITY_END();
+}
@@ -0,0 +1,106 @@
+// -----
+// test_main.cpp - Host test of MoistureModel.h
+// -----
+// 19.10.2026 created
+// -----
+
+#include <unity.h>
+#include <MoistureModel.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// calibration of the capacitive probes in the firmware, lower when wet
+#define DRY_RAW 4200
+#define WET_RAW 2000
+
+void test_first_reading_seeds(void)
+{
+  MoistureFilter filter;
+  moistureFilterReset(filter);
+
+  moistureFilterUpdate(filter, 3000);
+  TEST_ASSERT_TRUE(filter.valid);
+  TEST_ASSERT_EQUAL_UINT16(3000, moistureFilterRaw(filter));
+}
+
+// a quarter of the step per reading, compared with the average in floating point,
+// the integer average settles on the input
+void test_step_response(void)
+{
+  MoistureFilter filter;
+  moistureFilterReset(filter);
+  moistureFilterUpdate(filter, 4000);
+
+  double expected = 4000;
+  for (uint8_t n = 0; n < 40; n++) {
+    moistureFilterUpdate(filter, 2000);
+    expected += (2000 - expected) / 4;
+    TEST_ASSERT_UINT16_WITHIN(2, (uint16_t)expected, moistureFilterRaw(filter));
+  }
+  TEST_ASSERT_UINT16_WITHIN(1, 2000, moistureFilterRaw(filter));
+}
+
+// a constant input stays where it is, also at the top of the range
+void test_steady_state(void)
+{
+  MoistureFilter filter;
+  moistureFilterReset(filter);
+
+  for (uint8_t n = 0; n < 50; n++) {
+    moistureFilterUpdate(filter, MOISTURESENSORS_FULL_SCALE - MOISTURESENSORS_RAIL - 1);
+  }
+  TEST_ASSERT_EQUAL_UINT16(MOISTURESENSORS_FULL_SCALE - MOISTURESENSORS_RAIL - 1, moistureFilterRaw(filter));
+}
+
+// a missing probe reads at a rail, the average starts again after it
+void test_rails_invalid(void)
+{
+  MoistureFilter filter;
+  moistureFilterReset(filter);
+  moistureFilterUpdate(filter, 3000);
+
+  moistureFilterUpdate(filter, MOISTURESENSORS_RAIL);
+  TEST_ASSERT_FALSE(filter.valid);
+  moistureFilterUpdate(filter, MOISTURESENSORS_FULL_SCALE);
+  TEST_ASSERT_FALSE(filter.valid);
+
+  moistureFilterUpdate(filter, 2500);
+  TEST_ASSERT_TRUE(filter.valid);
+  TEST_ASSERT_EQUAL_UINT16(2500, moistureFilterRaw(filter));
+}
+
+void test_percent(void)
+{
+  TEST_ASSERT_EQUAL_UINT8(0, moisturePercent(DRY_RAW, DRY_RAW, WET_RAW));
+  TEST_ASSERT_EQUAL_UINT8(100, moisturePercent(WET_RAW, DRY_RAW, WET_RAW));
+  TEST_ASSERT_EQUAL_UINT8(50, moisturePercent(3100, DRY_RAW, WET_RAW));
+  TEST_ASSERT_EQUAL_UINT8(25, moisturePercent(3650, DRY_RAW, WET_RAW));
+}
+
+void test_percent_clamped(void)
+{
+  TEST_ASSERT_EQUAL_UINT8(0, moisturePercent(5000, DRY_RAW, WET_RAW));
+  TEST_ASSERT_EQUAL_UINT8(100, moisturePercent(1000, DRY_RAW, WET_RAW));
+}
+
+// resistive probes read higher when wet
+void test_percent_rising(void)
+{
+  TEST_ASSERT_EQUAL_UINT8(0, moisturePercent(1000, 1000, 5000));
+  TEST_ASSERT_EQUAL_UINT8(75, moisturePercent(4000, 1000, 5000));
+  TEST_ASSERT_EQUAL_UINT8(100, moisturePercent(8000, 1000, 5000));
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_first_reading_seeds);
+  RUN_TEST(test_step_response);
+  RUN_TEST(test_steady_state);
+  RUN_TEST(test_rails_invalid);
+  RUN_TEST(test_percent);
+  RUN_TEST(test_percent_clamped);
+  RUN_TEST(test_percent_rising);
+  return UNITY_END();
+}
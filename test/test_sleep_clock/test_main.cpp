@@ -0,0 +1,121 @@
+// -----
+// test_main.cpp - Host test of SleepClockModel.h
+// -----
+// 19.10.2026 created
+// -----
+
+#include <unity.h>
+#include <SleepClockModel.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Timer2 counts of 64 us, the first one may come up to a count early or
+// late, the prescaler is not reset with TCNT2.
+static unsigned long timer2Micros(unsigned long micros, unsigned long prescalerMicros)
+{
+  return (micros + prescalerMicros) / 64 * 64;
+}
+
+// the overflows are exact for every start of Timer0 and prescaler phase
+void test_overflows_exact(void)
+{
+  for (unsigned int start = 0; start < 256; start += 5) {
+    for (unsigned long micros = 0; micros < 40000; micros += 28) {
+      unsigned long expected = (start * 4 + micros) / 1024;
+      uint8_t end = (start + micros / 4) % 256;
+
+      TEST_ASSERT_EQUAL_UINT32(expected, sleepOverflows(timer2Micros(micros, 0), start, end));
+      TEST_ASSERT_EQUAL_UINT32(expected, sleepOverflows(timer2Micros(micros, 63), start, end));
+    }
+  }
+}
+
+// one overflow at a time like wiring.c: 1 ms and 3/125 ms
+void test_advance_like_core(void)
+{
+  volatile unsigned long millis = 0, overflows = 0;
+  volatile uint16_t fract = 0;
+  unsigned long coreMillis = 0;
+  uint8_t coreFract = 0;
+
+  for (int i = 0; i < 5000; i++) {
+    sleepAdvanceClock(millis, overflows, fract, 1);
+    coreMillis++;
+    coreFract += 3;
+    if (coreFract >= 125) {
+      coreFract -= 125;
+      coreMillis++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(coreMillis, millis);
+  }
+  TEST_ASSERT_EQUAL_UINT32(5000, overflows);
+}
+
+// the Timer2 interrupt adds 8 overflows per tick, the same as 8 single ones
+void test_advance_by_ticks(void)
+{
+  volatile unsigned long tickMillis = 0, tickOverflows = 0;
+  volatile uint16_t tickFract = 0;
+  volatile unsigned long millis = 0, overflows = 0;
+  volatile uint16_t fract = 0;
+
+  for (int i = 0; i < 1000; i++) {
+    sleepAdvanceClock(tickMillis, tickOverflows, tickFract, 8);
+  }
+  sleepAdvanceClock(millis, overflows, fract, 8000);
+  TEST_ASSERT_EQUAL_UINT32(millis, tickMillis);
+  TEST_ASSERT_EQUAL_UINT16(fract, tickFract);
+  TEST_ASSERT_EQUAL_UINT32(8192, millis);
+}
+
+// A sleep of a few ticks with a pending one: the interrupt counted 8
+// overflows per handled tick, the rest is added when leaving.
+void test_sleep_with_pending_tick(void)
+{
+  volatile unsigned long millis = 0, overflows = 0;
+  volatile uint16_t fract = 0;
+  uint8_t start = 100;
+  unsigned long micros = 3 * 8192 + 5000; // 2 ticks handled, 1 pending, 5 ms
+  uint8_t end = (start + micros / 4) % 256;
+
+  sleepAdvanceClock(millis, overflows, fract, 2 * 8);
+  unsigned long total = sleepOverflows(timer2Micros(micros, 30), start, end);
+  sleepAdvanceClock(millis, overflows, fract, total - 2 * 8);
+
+  TEST_ASSERT_EQUAL_UINT32((start * 4 + micros) / 1024, overflows);
+  TEST_ASSERT_UINT32_WITHIN(2, micros / 1000, millis);
+}
+
+// the moisture window wakes every 104 us, before the first Timer2 tick:
+// millis() must keep up over a second of such sleeps
+void test_many_short_sleeps(void)
+{
+  volatile unsigned long millis = 0, overflows = 0;
+  volatile uint16_t fract = 0;
+  unsigned long counts = 0; // Timer0 counts of 4 us since the start
+
+  for (int i = 0; i < 10000; i++) {
+    uint8_t start = counts % 256;
+    counts += 20; // 80 us asleep
+    sleepAdvanceClock(millis, overflows, fract, sleepOverflows(timer2Micros(80, i % 64), start, counts % 256));
+    counts += 6; // 24 us awake, overflows counted by the Timer0 interrupt
+    if ((counts % 256) < 6) {
+      sleepAdvanceClock(millis, overflows, fract, 1);
+    }
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(counts / 256, overflows);
+  TEST_ASSERT_UINT32_WITHIN(2, 1040, millis);
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_overflows_exact);
+  RUN_TEST(test_advance_like_core);
+  RUN_TEST(test_advance_by_ticks);
+  RUN_TEST(test_sleep_with_pending_tick);
+  RUN_TEST(test_many_short_sleeps);
+  return UNITY_END();
+}
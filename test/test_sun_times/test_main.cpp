@@ -0,0 +1,163 @@
+// -----
+// test_main.cpp - Host test of SunTimes against the NOAA formulas in double
+// precision.
+// -----
+// 19.10.2026 created
+// -----
+
+#include <unity.h>
+#include <math.h>
+#include <SunTimes.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/**
+ * sunrise and sunset in minutes of the local day, the same NOAA series as
+ * SunTimes in double precision. Returns false when the sun does not rise and set.
+ * cosHourAngle is near 1 or -1 on the days around polar night and midnight sun.
+ */
+static bool referenceTimes(double latitude, double longitude, int utcOffset, int dayOfYear,
+                           double &sunrise, double &sunset, double &cosHourAngle)
+{
+  double g = 2 * M_PI / 365 * (dayOfYear - 1);
+  double equation = 229.18 * (0.000075 + 0.001868 * cos(g) - 0.032077 * sin(g)
+    - 0.014615 * cos(2 * g) - 0.040849 * sin(2 * g));
+  double declination = 0.006918 - 0.399912 * cos(g) + 0.070257 * sin(g) - 0.006758 * cos(2 * g)
+    + 0.000907 * sin(2 * g) - 0.002697 * cos(3 * g) + 0.00148 * sin(3 * g);
+  double lat = latitude * M_PI / 180;
+
+  cosHourAngle = cos(90.833 * M_PI / 180) / (cos(lat) * cos(declination)) - tan(lat) * tan(declination);
+  if ((cosHourAngle >= 1) || (cosHourAngle <= -1)) {
+    return false;
+  }
+  double hourAngle = acos(cosHourAngle) * 180 / M_PI;
+
+  sunrise = fmod(720 - 4 * (longitude + hourAngle) - equation + utcOffset + 2880, 1440);
+  sunset = fmod(720 - 4 * (longitude - hourAngle) - equation + utcOffset + 2880, 1440);
+  return true;
+}
+
+// difference of two minutes of the day, across midnight
+static double minuteDifference(double reference, int16_t minute)
+{
+  double difference = fabs(reference - minute);
+  return (difference > 720) ? 1440 - difference : difference;
+}
+
+/**
+ * every day of the year at one place: the same days have a sunrise and
+ * sunset, and the times are within toleranceMinutes of the reference.
+ * Where the sun only just rises or sets, the hour angle is ill-conditioned
+ * and the last bit decides, so these days are left out of the decision.
+ */
+static void checkPlace(int16_t latitude, int16_t longitude, int16_t utcOffset, double toleranceMinutes)
+{
+  SunTimes sun(latitude, longitude, utcOffset);
+
+  for (int day = 1; day <= 366; day++) {
+    double sunrise, sunset, cosHourAngle;
+    bool expected = referenceTimes(latitude / 100.0, longitude / 100.0, utcOffset, day, sunrise, sunset, cosHourAngle);
+
+    bool computed = sun.compute(day);
+    if (fabs(cosHourAngle) > 0.999) {
+      continue;
+    }
+    TEST_ASSERT_EQUAL(expected, computed);
+    TEST_ASSERT_EQUAL(expected, sun.isValid());
+    if (!expected) {
+      TEST_ASSERT_EQUAL_INT16(SUNTIMES_NONE, sun.getSunrise());
+      TEST_ASSERT_EQUAL_INT16(SUNTIMES_NONE, sun.getSunset());
+      continue;
+    }
+    TEST_ASSERT_TRUE(minuteDifference(sunrise, sun.getSunrise()) <= toleranceMinutes);
+    TEST_ASSERT_TRUE(minuteDifference(sunset, sun.getSunset()) <= toleranceMinutes);
+  }
+}
+
+void test_equator(void)
+{
+  checkPlace(0, 0, 0, 1.0);
+}
+
+void test_prague(void)
+{
+  checkPlace(5008, 1442, 60, 1.0);
+}
+
+void test_southern_hemisphere(void)
+{
+  checkPlace(-3387, 15121, 600, 1.0); // Sydney
+}
+
+void test_west_of_greenwich(void)
+{
+  checkPlace(4071, -7401, -300, 1.0); // New York
+}
+
+void test_near_polar_circle(void)
+{
+  checkPlace(6500, 2547, 120, 1.0); // Oulu
+}
+
+// a few minutes close to the days of polar night and midnight sun
+void test_polar(void)
+{
+  checkPlace(7822, 1565, 60, 3.0); // Longyearbyen
+  checkPlace(-7800, 16667, 720, 3.0); // McMurdo
+}
+
+// Prague, CET: known times of the solstices within the accuracy of the formulas
+void test_prague_solstices(void)
+{
+  SunTimes sun(5008, 1442, 60);
+
+  TEST_ASSERT_TRUE(sun.compute(172)); // June 21st
+  TEST_ASSERT_INT16_WITHIN(3, 3 * 60 + 52, sun.getSunrise());
+  TEST_ASSERT_INT16_WITHIN(3, 20 * 60 + 14, sun.getSunset());
+
+  TEST_ASSERT_TRUE(sun.compute(355)); // December 21st
+  TEST_ASSERT_INT16_WITHIN(3, 7 * 60 + 58, sun.getSunrise());
+  TEST_ASSERT_INT16_WITHIN(3, 16 * 60 + 2, sun.getSunset());
+}
+
+// Longyearbyen: midnight sun in June, polar night in December
+void test_polar_day_and_night(void)
+{
+  SunTimes north(7822, 1565, 60);
+  TEST_ASSERT_FALSE(north.compute(172));
+  TEST_ASSERT_FALSE(north.isValid());
+  TEST_ASSERT_EQUAL_INT16(SUNTIMES_NONE, north.getSunrise());
+  TEST_ASSERT_FALSE(north.compute(355));
+  TEST_ASSERT_TRUE(north.compute(80)); // equinox
+
+  SunTimes south(-7000, 0, 0);
+  TEST_ASSERT_FALSE(south.compute(172)); // polar night in June
+}
+
+void test_trigonometry(void)
+{
+  for (uint32_t angle = 0; angle < 65536; angle += 97) {
+    double radians = angle * 2 * M_PI / 65536;
+    TEST_ASSERT_DOUBLE_WITHIN(1e-3, sin(radians), SunTimes::sinQ15(angle) / 32768.0);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-3, cos(radians), SunTimes::cosQ15(angle) / 32768.0);
+  }
+  for (int32_t value = -32768; value < 32768; value += 61) {
+    TEST_ASSERT_DOUBLE_WITHIN(3e-4, acos(value / 32768.0), SunTimes::acosQ15(value) / 32768.0);
+  }
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_equator);
+  RUN_TEST(test_prague);
+  RUN_TEST(test_southern_hemisphere);
+  RUN_TEST(test_west_of_greenwich);
+  RUN_TEST(test_near_polar_circle);
+  RUN_TEST(test_polar);
+  RUN_TEST(test_prague_solstices);
+  RUN_TEST(test_polar_day_and_night);
+  RUN_TEST(test_trigonometry);
+  return UNITY_END();
+}